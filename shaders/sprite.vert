@@ -1,9 +1,21 @@
 #version 450
 
+struct SpriteInstance {
+    vec4 uv_rect;
+    vec2 position;
+    vec2 size;
+    vec2 flipped;
+    float z;
+    uint page;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Instances {
+    SpriteInstance instances[];
+};
+
 layout(set = 1, binding = 0) uniform UBO {
     mat4 camera;
-    mat4 model;
-    vec2 flipped;
+    uint first_instance;
 } ubo;
 
 layout(location = 0) out vec2 tex_coords;
@@ -27,6 +39,9 @@ vec2 uv[6] = vec2[](
 );
 
 void main() {
-    gl_Position = ubo.camera * ubo.model * vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    tex_coords = ubo.flipped * uv[gl_VertexIndex];
+    SpriteInstance instance = instances[ubo.first_instance + gl_InstanceIndex];
+    vec2 position = instance.position + positions[gl_VertexIndex] * instance.size;
+    gl_Position = ubo.camera * vec4(position, instance.z, 1.0);
+    vec2 local_uv = mix(uv[gl_VertexIndex], 1.0 - uv[gl_VertexIndex], lessThan(instance.flipped, vec2(0.0)));
+    tex_coords = instance.uv_rect.xy + local_uv * instance.uv_rect.zw;
 }
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+struct Aabb
+{
+    glm::vec2 min;
+    glm::vec2 max;
+
+    [[nodiscard]] bool overlaps(const Aabb &other) const
+    {
+        return min.x <= other.max.x && other.min.x <= max.x && min.y <= other.max.y &&
+               other.min.y <= max.y;
+    }
+};
@@ -0,0 +1,216 @@
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <SDL3/SDL_audio.h>
+#include <SDL3/SDL_stdinc.h>
+#include <spdlog/spdlog.h>
+
+#include "asset_loader.hpp"
+#include "asset_pack.hpp"
+#include "read_file.hpp"
+#include "texture_atlas.hpp"
+
+// Offline tool that converts the game's assets into a single pack file, see `asset_pack.hpp`.
+// Images are decoded and padded the way the texture atlas expects them, sounds are converted to
+// `PACK_AUDIO_SPEC` and anything else is copied as is. Every input is given as `<name>=<path>`,
+// where `name` is the path the game loads the asset from.
+
+struct CookedEntry
+{
+    PackEntry entry;
+    std::vector<uint8_t> data;
+};
+
+static bool ends_with(std::string_view str, std::string_view suffix)
+{
+    return str.size() >= suffix.size() && str.substr(str.size() - suffix.size()) == suffix;
+}
+
+static std::optional<CookedEntry> cook_image(const std::string &path)
+{
+    std::optional<ImageData> image = decode_image_file(path);
+    if (!image)
+    {
+        return {};
+    }
+
+    CookedEntry cooked{
+        .entry = {},
+        .data = {},
+    };
+    cooked.entry.type = PackEntryType::image;
+    cooked.entry.width = image->width;
+    cooked.entry.height = image->height;
+    cooked.entry.padding = TextureAtlas::PADDING;
+    cooked.data.resize(
+        static_cast<size_t>(image->width + 2 * TextureAtlas::PADDING) *
+        (image->height + 2 * TextureAtlas::PADDING) * 4
+    );
+    extrude_image(*image, TextureAtlas::PADDING, cooked.data.data());
+    return cooked;
+}
+
+static std::optional<CookedEntry> cook_sound(const std::string &path)
+{
+    std::optional<WavData> wav = decode_wav_file(path);
+    if (!wav)
+    {
+        return {};
+    }
+
+    uint8_t *converted;
+    int converted_len;
+    if (!SDL_ConvertAudioSamples(
+            &wav->spec,
+            wav->samples.data(),
+            static_cast<int>(wav->samples.size()),
+            &PACK_AUDIO_SPEC,
+            &converted,
+            &converted_len
+        ))
+    {
+        spdlog::error("cook_sound: failed to convert {}: {}", path, SDL_GetError());
+        return {};
+    }
+
+    CookedEntry cooked{
+        .entry = {},
+        .data = std::vector<uint8_t>(converted, converted + converted_len),
+    };
+    SDL_free(converted);
+    cooked.entry.type = PackEntryType::sound;
+    cooked.entry.audio_format = PACK_AUDIO_SPEC.format;
+    cooked.entry.audio_channels = static_cast<uint32_t>(PACK_AUDIO_SPEC.channels);
+    cooked.entry.audio_frequency = static_cast<uint32_t>(PACK_AUDIO_SPEC.freq);
+    return cooked;
+}
+
+static std::optional<CookedEntry> cook_blob(const std::string &path)
+{
+    try
+    {
+        CookedEntry cooked{
+            .entry = {},
+            .data = read_file(path),
+        };
+        cooked.entry.type = PackEntryType::blob;
+        return cooked;
+    }
+    catch (std::exception &)
+    {
+        return {};
+    }
+}
+
+static bool write_pack(const std::string &path, std::vector<CookedEntry> &entries)
+{
+    uint64_t offset = sizeof(PackHeader) + entries.size() * sizeof(PackEntry);
+    for (auto &cooked : entries)
+    {
+        offset = (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+        cooked.entry.offset = offset;
+        cooked.entry.size = cooked.data.size();
+        offset += cooked.data.size();
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open())
+    {
+        spdlog::error("write_pack: failed to open {}", path);
+        return false;
+    }
+
+    PackHeader header{
+        .magic = PACK_MAGIC,
+        .version = PACK_VERSION,
+        .entry_count = static_cast<uint32_t>(entries.size()),
+        .reserved = 0,
+    };
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const auto &cooked : entries)
+    {
+        out.write(reinterpret_cast<const char *>(&cooked.entry), sizeof(cooked.entry));
+    }
+
+    uint64_t position = sizeof(PackHeader) + entries.size() * sizeof(PackEntry);
+    for (const auto &cooked : entries)
+    {
+        static constexpr std::array<char, PACK_ALIGNMENT> zeros{};
+        out.write(zeros.data(), static_cast<std::streamsize>(cooked.entry.offset - position));
+        out.write(
+            reinterpret_cast<const char *>(cooked.data.data()),
+            static_cast<std::streamsize>(cooked.data.size())
+        );
+        position = cooked.entry.offset + cooked.entry.size;
+    }
+
+    if (!out.good())
+    {
+        spdlog::error("write_pack: failed to write {}", path);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        spdlog::error("main: usage: {} <output.pack> [<name>=<path>]...", argv[0]);
+        return 1;
+    }
+
+    std::vector<CookedEntry> entries;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        size_t separator = arg.find('=');
+        if (separator == std::string_view::npos)
+        {
+            spdlog::error("main: expected `<name>=<path>`, got `{}`", arg);
+            return 1;
+        }
+
+        std::string_view name = arg.substr(0, separator);
+        std::string path(arg.substr(separator + 1));
+        if (name.size() >= sizeof(PackEntry::name))
+        {
+            spdlog::error("main: asset name `{}` is too long", name);
+            return 1;
+        }
+
+        std::optional<CookedEntry> cooked;
+        if (ends_with(path, ".png"))
+        {
+            cooked = cook_image(path);
+        }
+        else if (ends_with(path, ".wav"))
+        {
+            cooked = cook_sound(path);
+        }
+        else
+        {
+            cooked = cook_blob(path);
+        }
+        if (!cooked)
+        {
+            spdlog::error("main: failed to cook {}", path);
+            return 1;
+        }
+
+        std::memcpy(cooked->entry.name.data(), name.data(), name.size());
+        spdlog::info("main: cooked {} ({} bytes)", name, cooked->data.size());
+        entries.push_back(std::move(*cooked));
+    }
+
+    if (!write_pack(argv[1], entries))
+    {
+        return 1;
+    }
+    spdlog::info("main: wrote {} entries to {}", entries.size(), argv[1]);
+
+    return 0;
+}
@@ -0,0 +1,27 @@
+#include "asset_data.hpp"
+
+#include <algorithm>
+
+void extrude_image(const ImageData &image, uint32_t padding, uint8_t *dst)
+{
+    const uint8_t *src = image.get_pixels();
+    uint32_t src_width = image.get_padded_width();
+    uint32_t dst_width = image.width + 2 * padding;
+    uint32_t dst_height = image.height + 2 * padding;
+
+    for (uint32_t y = 0; y < dst_height; ++y)
+    {
+        uint32_t src_y = std::clamp(y, padding, image.height + padding - 1) - padding;
+        for (uint32_t x = 0; x < dst_width; ++x)
+        {
+            uint32_t src_x = std::clamp(x, padding, image.width + padding - 1) - padding;
+            std::copy_n(
+                src + ((static_cast<size_t>(src_y) + image.padding) * src_width + src_x +
+                       image.padding) *
+                          4,
+                4,
+                dst + (static_cast<size_t>(y) * dst_width + x) * 4
+            );
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL_audio.h>
+
+// Decoded image, 4 bytes per pixel in RGBA order. `width` and `height` do not include the
+// `padding` texels of repeated edge that surround the image on every side. The pixels either live
+// in `storage` or are borrowed from a memory-mapped asset pack that outlives the image.
+struct ImageData
+{
+    std::vector<uint8_t> storage;
+    const uint8_t *borrowed_pixels{nullptr};
+    uint32_t width{0};
+    uint32_t height{0};
+    uint32_t padding{0};
+
+    [[nodiscard]] const uint8_t *get_pixels() const
+    {
+        return borrowed_pixels != nullptr ? borrowed_pixels : storage.data();
+    }
+
+    [[nodiscard]] uint32_t get_padded_width() const
+    {
+        return width + 2 * padding;
+    }
+
+    [[nodiscard]] uint32_t get_padded_height() const
+    {
+        return height + 2 * padding;
+    }
+};
+
+// Writes `image` surrounded by `padding` copies of its edge texels to `dst`, which must hold
+// `(width + 2 * padding) * (height + 2 * padding)` pixels.
+void extrude_image(const ImageData &image, uint32_t padding, uint8_t *dst);
+
+// Decoded PCM samples in the format described by `spec`.
+struct WavData
+{
+    SDL_AudioSpec spec{};
+    std::vector<uint8_t> samples;
+};
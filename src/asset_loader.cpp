@@ -0,0 +1,81 @@
+#include "asset_loader.hpp"
+
+#include <SDL3/SDL_stdinc.h>
+#include <spdlog/spdlog.h>
+#include <stb_image.h>
+
+#include "profiler.hpp"
+
+std::optional<ImageData> decode_image_file(const std::string &path)
+{
+    PROFILE_ZONE("decode_image_file");
+    int width, height;
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, nullptr, 4);
+    if (!data)
+    {
+        spdlog::error("decode_image_file: failed to open image file `{}`", path);
+        return {};
+    }
+
+    ImageData image{
+        .storage = std::vector<uint8_t>(data, data + static_cast<size_t>(width) * height * 4),
+        .borrowed_pixels = nullptr,
+        .width = static_cast<uint32_t>(width),
+        .height = static_cast<uint32_t>(height),
+        .padding = 0,
+    };
+    stbi_image_free(data);
+    return image;
+}
+
+std::optional<WavData> decode_wav_file(const std::string &path)
+{
+    PROFILE_ZONE("decode_wav_file");
+    SDL_AudioSpec spec;
+    uint8_t *data;
+    uint32_t len;
+    if (!SDL_LoadWAV(path.c_str(), &spec, &data, &len))
+    {
+        spdlog::error("decode_wav_file: failed to open wav `{}`: {}", path, SDL_GetError());
+        return {};
+    }
+
+    WavData wav{
+        .spec = spec,
+        .samples = std::vector<uint8_t>(data, data + len),
+    };
+    SDL_free(data);
+    return wav;
+}
+
+template<typename T>
+static std::future<std::optional<T>> make_ready_future(std::optional<T> &&value)
+{
+    std::promise<std::optional<T>> promise;
+    promise.set_value(std::move(value));
+    return promise.get_future();
+}
+
+std::future<std::optional<ImageData>> AssetLoader::load_image(std::string path)
+{
+    if (m_pack != nullptr && m_pack->is_open())
+    {
+        if (auto image = m_pack->get_image(get_pack_name(path)))
+        {
+            return make_ready_future(std::move(image));
+        }
+    }
+    return m_thread_pool->submit([path = std::move(path)] { return decode_image_file(path); });
+}
+
+std::future<std::optional<WavData>> AssetLoader::load_wav(std::string path)
+{
+    if (m_pack != nullptr && m_pack->is_open())
+    {
+        if (auto wav = m_pack->get_sound(get_pack_name(path)))
+        {
+            return make_ready_future(std::move(wav));
+        }
+    }
+    return m_thread_pool->submit([path = std::move(path)] { return decode_wav_file(path); });
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <future>
+#include <optional>
+#include <string>
+
+#include "asset_data.hpp"
+#include "asset_pack.hpp"
+#include "thread_pool.hpp"
+
+[[nodiscard]] std::optional<ImageData> decode_image_file(const std::string &path);
+
+[[nodiscard]] std::optional<WavData> decode_wav_file(const std::string &path);
+
+// Reads and decodes asset files on a thread pool. The returned futures are the handles to the
+// assets, GPU and audio device uploads are left to the caller on the main thread so that they can
+// be batched once every asset of a set has been decoded. Assets found in the asset pack are
+// returned right away without decoding, images pointing straight into the pack.
+class AssetLoader
+{
+    ThreadPool *m_thread_pool;
+    const AssetPack *m_pack;
+
+  public:
+    explicit AssetLoader(ThreadPool *thread_pool, const AssetPack *pack = nullptr)
+        : m_thread_pool(thread_pool), m_pack(pack)
+    {
+    }
+
+    [[nodiscard]] std::future<std::optional<ImageData>> load_image(std::string path);
+
+    [[nodiscard]] std::future<std::optional<WavData>> load_wav(std::string path);
+};
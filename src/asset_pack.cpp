@@ -0,0 +1,135 @@
+#include "asset_pack.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <spdlog/spdlog.h>
+
+bool AssetPack::open(const std::string &path)
+{
+    m_entries.clear();
+    if (!m_file.open(path))
+    {
+        return false;
+    }
+
+    std::span<const uint8_t> data = m_file.get_data();
+    PackHeader header;
+    if (data.size() < sizeof(header))
+    {
+        spdlog::error("AssetPack::open: {} is too small to be an asset pack", path);
+        m_file.close();
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (header.magic != PACK_MAGIC || header.version != PACK_VERSION)
+    {
+        spdlog::error("AssetPack::open: {} is not a version {} asset pack", path, PACK_VERSION);
+        m_file.close();
+        return false;
+    }
+
+    if ((data.size() - sizeof(header)) / sizeof(PackEntry) < header.entry_count)
+    {
+        spdlog::error("AssetPack::open: entry table of {} is truncated", path);
+        m_file.close();
+        return false;
+    }
+
+    // the mapping is page aligned and the header is 16 bytes, so entries can be used in place
+    const auto *entries = reinterpret_cast<const PackEntry *>(data.data() + sizeof(header));
+    for (uint32_t i = 0; i < header.entry_count; ++i)
+    {
+        const PackEntry &entry = entries[i];
+        auto name_end = std::find(entry.name.begin(), entry.name.end(), '\0');
+        if (name_end == entry.name.end() || entry.offset > data.size() ||
+            entry.size > data.size() - entry.offset)
+        {
+            spdlog::error("AssetPack::open: entry {} of {} is invalid", i, path);
+            m_entries.clear();
+            m_file.close();
+            return false;
+        }
+
+        bool valid_type = true;
+        switch (entry.type)
+        {
+            case PackEntryType::image:
+                valid_type = entry.size ==
+                             (static_cast<uint64_t>(entry.width) + 2 * entry.padding) *
+                                 (static_cast<uint64_t>(entry.height) + 2 * entry.padding) * 4;
+                break;
+            case PackEntryType::sound:
+            case PackEntryType::blob:
+                break;
+            default:
+                valid_type = false;
+        }
+        if (!valid_type)
+        {
+            spdlog::error("AssetPack::open: entry {} of {} has an invalid type or size", i, path);
+            m_entries.clear();
+            m_file.close();
+            return false;
+        }
+
+        m_entries.emplace(std::string_view(entry.name.data(), name_end), &entry);
+    }
+
+    spdlog::info("AssetPack::open: opened {} with {} entries", path, m_entries.size());
+    return true;
+}
+
+const PackEntry *AssetPack::find(std::string_view name) const
+{
+    auto it = m_entries.find(name);
+    return it != m_entries.end() ? it->second : nullptr;
+}
+
+std::optional<ImageData> AssetPack::get_image(std::string_view name) const
+{
+    const PackEntry *entry = find(name);
+    if (entry == nullptr || entry->type != PackEntryType::image)
+    {
+        return {};
+    }
+
+    return ImageData{
+        .storage = {},
+        .borrowed_pixels = get_data(*entry).data(),
+        .width = entry->width,
+        .height = entry->height,
+        .padding = entry->padding,
+    };
+}
+
+std::optional<WavData> AssetPack::get_sound(std::string_view name) const
+{
+    const PackEntry *entry = find(name);
+    if (entry == nullptr || entry->type != PackEntryType::sound)
+    {
+        return {};
+    }
+
+    std::span<const uint8_t> samples = get_data(*entry);
+    return WavData{
+        .spec =
+            SDL_AudioSpec{
+                .format = static_cast<SDL_AudioFormat>(entry->audio_format),
+                .channels = static_cast<int>(entry->audio_channels),
+                .freq = static_cast<int>(entry->audio_frequency),
+            },
+        .samples = std::vector<uint8_t>(samples.begin(), samples.end()),
+    };
+}
+
+std::optional<std::span<const uint8_t>> AssetPack::get_blob(std::string_view name) const
+{
+    const PackEntry *entry = find(name);
+    if (entry == nullptr || entry->type != PackEntryType::blob)
+    {
+        return {};
+    }
+    return get_data(*entry);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "asset_data.hpp"
+#include "mapped_file.hpp"
+
+// Layout of a pack file written by `asset_cooker`: a `PackHeader`, `entry_count` `PackEntry`s and
+// then the entry data, each entry starting at a multiple of `PACK_ALIGNMENT`. All integers are
+// little endian.
+static constexpr std::array<char, 4> PACK_MAGIC{'P', 'F', 'P', 'K'};
+static constexpr uint32_t PACK_VERSION = 1;
+static constexpr uint64_t PACK_ALIGNMENT = 16;
+
+// Cooked sounds are stored in the format most playback devices use, so that they can be played
+// without conversion.
+static constexpr SDL_AudioSpec PACK_AUDIO_SPEC{
+    .format = SDL_AUDIO_F32,
+    .channels = 2,
+    .freq = 48000,
+};
+
+struct PackHeader
+{
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+};
+
+enum class PackEntryType : uint32_t
+{
+    // RGBA8 texels, `width` and `height` exclude `padding` texels of repeated edge on every side
+    image = 0,
+    // PCM samples in the format given by `audio_format`, `audio_channels` and `audio_frequency`
+    sound = 1,
+    // any other file, stored as is
+    blob = 2,
+};
+
+struct PackEntry
+{
+    // path of the source file relative to the game's working directory, nul terminated
+    std::array<char, 64> name;
+    PackEntryType type;
+    uint32_t width;
+    uint32_t height;
+    uint32_t padding;
+    uint32_t audio_format;
+    uint32_t audio_channels;
+    uint32_t audio_frequency;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+static_assert(sizeof(PackHeader) == 16);
+static_assert(sizeof(PackEntry) == 112);
+
+// Name of the asset loaded from `path` in a pack, that is the path without a leading `./`.
+[[nodiscard]] inline std::string_view get_pack_name(std::string_view path)
+{
+    return path.starts_with("./") ? path.substr(2) : path;
+}
+
+// Memory-mapped pack file. Images are handed out as pointers into the mapping, which stays valid
+// for as long as the pack is open.
+class AssetPack
+{
+    MappedFile m_file;
+    std::unordered_map<std::string_view, const PackEntry *> m_entries;
+
+  public:
+    [[nodiscard]] bool open(const std::string &path);
+
+    [[nodiscard]] bool is_open() const
+    {
+        return m_file.is_open();
+    }
+
+    [[nodiscard]] const PackEntry *find(std::string_view name) const;
+
+    [[nodiscard]] std::span<const uint8_t> get_data(const PackEntry &entry) const
+    {
+        return m_file.get_data().subspan(entry.offset, entry.size);
+    }
+
+    [[nodiscard]] std::optional<ImageData> get_image(std::string_view name) const;
+
+    [[nodiscard]] std::optional<WavData> get_sound(std::string_view name) const;
+
+    [[nodiscard]] std::optional<std::span<const uint8_t>> get_blob(std::string_view name) const;
+};
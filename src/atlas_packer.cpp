@@ -0,0 +1,131 @@
+#include "atlas_packer.hpp"
+
+#include <algorithm>
+
+AtlasPacker::AtlasPacker(uint32_t width, uint32_t height) : m_width(width), m_height(height)
+{
+    reset();
+}
+
+void AtlasPacker::reset()
+{
+    m_used_area = 0;
+    m_skyline.clear();
+    m_skyline.push_back(SkylineNode{.x = 0, .y = 0, .width = m_width});
+}
+
+float AtlasPacker::get_occupancy() const
+{
+    return static_cast<float>(m_used_area) /
+           static_cast<float>(static_cast<uint64_t>(m_width) * m_height);
+}
+
+std::optional<AtlasRect> AtlasPacker::pack(uint32_t width, uint32_t height)
+{
+    if (width == 0 || height == 0 || width > m_width || height > m_height)
+    {
+        return {};
+    }
+
+    std::optional<size_t> best_idx;
+    uint32_t best_y = 0;
+    uint32_t best_width = 0;
+    for (size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        std::optional<uint32_t> y = fit(i, width, height);
+        if (!y)
+        {
+            continue;
+        }
+
+        // prefer the lowest position, then the narrowest segment to limit wasted space
+        if (!best_idx || *y < best_y || (*y == best_y && m_skyline[i].width < best_width))
+        {
+            best_idx = i;
+            best_y = *y;
+            best_width = m_skyline[i].width;
+        }
+    }
+
+    if (!best_idx)
+    {
+        return {};
+    }
+
+    AtlasRect rect{
+        .x = m_skyline[*best_idx].x,
+        .y = best_y,
+        .width = width,
+        .height = height,
+    };
+    insert(*best_idx, rect);
+    m_used_area += static_cast<uint64_t>(width) * height;
+
+    return rect;
+}
+
+std::optional<uint32_t> AtlasPacker::fit(size_t node_idx, uint32_t width, uint32_t height) const
+{
+    uint32_t x = m_skyline[node_idx].x;
+    if (x + width > m_width)
+    {
+        return {};
+    }
+
+    uint32_t y = 0;
+    uint32_t remaining = width;
+    for (size_t i = node_idx; remaining > 0; ++i)
+    {
+        y = std::max(y, m_skyline[i].y);
+        if (y + height > m_height)
+        {
+            return {};
+        }
+        remaining -= std::min(remaining, m_skyline[i].width);
+    }
+
+    return y;
+}
+
+void AtlasPacker::insert(size_t node_idx, const AtlasRect &rect)
+{
+    m_skyline.insert(
+        m_skyline.begin() + static_cast<ptrdiff_t>(node_idx),
+        SkylineNode{.x = rect.x, .y = rect.y + rect.height, .width = rect.width}
+    );
+
+    // shrink or remove the nodes now covered by the new one
+    uint32_t right = rect.x + rect.width;
+    for (size_t i = node_idx + 1; i < m_skyline.size();)
+    {
+        auto &node = m_skyline[i];
+        if (node.x >= right)
+        {
+            break;
+        }
+
+        uint32_t node_right = node.x + node.width;
+        if (node_right <= right)
+        {
+            m_skyline.erase(m_skyline.begin() + static_cast<ptrdiff_t>(i));
+            continue;
+        }
+
+        node.width = node_right - right;
+        node.x = right;
+        break;
+    }
+
+    for (size_t i = 0; i + 1 < m_skyline.size();)
+    {
+        if (m_skyline[i].y == m_skyline[i + 1].y)
+        {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + static_cast<ptrdiff_t>(i + 1));
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
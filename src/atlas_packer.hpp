@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+struct AtlasRect
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+// Skyline bottom-left rectangle packer. Placement only depends on the sequence of
+// requested sizes, so packing the same images in the same order always gives the same
+// layout.
+class AtlasPacker
+{
+    struct SkylineNode
+    {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+    };
+
+    uint32_t m_width;
+    uint32_t m_height;
+    uint64_t m_used_area{0};
+    std::vector<SkylineNode> m_skyline;
+
+  public:
+    AtlasPacker(uint32_t width, uint32_t height);
+
+    [[nodiscard]] std::optional<AtlasRect> pack(uint32_t width, uint32_t height);
+
+    void reset();
+
+    [[nodiscard]] uint32_t get_width() const
+    {
+        return m_width;
+    }
+
+    [[nodiscard]] uint32_t get_height() const
+    {
+        return m_height;
+    }
+
+    [[nodiscard]] float get_occupancy() const;
+
+  private:
+    [[nodiscard]] std::optional<uint32_t>
+    fit(size_t node_idx, uint32_t width, uint32_t height) const;
+
+    void insert(size_t node_idx, const AtlasRect &rect);
+};
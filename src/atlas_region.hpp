@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+struct AtlasRegion
+{
+    uint32_t page;
+    // x, y: top-left corner, z, w: extent; all in normalized texture coordinates
+    glm::vec4 uv_rect;
+};
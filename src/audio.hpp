@@ -1,40 +1,50 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
 
-#include <SDL3/SDL_audio.h>
-#include <spdlog/spdlog.h>
+#include "asset_data.hpp"
+#include "slot_map.hpp"
 
-typedef size_t AudioSourceId;
-
-struct AudioSource
-{
-    uint8_t *data;
-    uint32_t data_len;
-    SDL_AudioStream *stream;
-};
+typedef SlotMapHandle AudioSourceId;
+typedef SlotMapHandle AudioStreamId;
+typedef uint32_t AudioVoiceId;
 
 class Audio
 {
-    SDL_AudioDeviceID m_device{0};
-    SDL_AudioSpec m_device_spec{};
+  public:
+    virtual ~Audio() = default;
 
-    std::vector<AudioSource> m_audio_sources;
+    [[nodiscard]] virtual std::optional<AudioSourceId> new_source(WavData wav) = 0;
 
-    Audio(const Audio &) = delete;
-    Audio &operator=(const Audio &) = delete;
-    Audio(Audio &&) = delete;
-    Audio &operator=(Audio &&) = delete;
+    // stops the source if it is playing, stale ids are ignored
+    virtual void free_source(AudioSourceId id) = 0;
 
-  public:
-    Audio() = default;
+    // Voice calls may be made from any thread and never block, the sound starts on the next
+    // mix. `pan` ranges from -1 (left) to 1 (right), stale ids are ignored.
+    virtual AudioVoiceId play(
+        AudioSourceId id, float gain = 1.0f, float pan = 0.0f, float pitch = 1.0f
+    ) = 0;
+
+    // ignored once the voice has finished or was taken by a newer sound
+    virtual void stop(AudioVoiceId voice) = 0;
+
+    virtual void set_voice_params(AudioVoiceId voice, float gain, float pan) = 0;
+
+    virtual void set_voice_pitch(AudioVoiceId voice, float pitch) = 0;
 
-    ~Audio();
+    // Opens a WAV file that is streamed from disk while it plays instead of being loaded, for
+    // long tracks such as music.
+    [[nodiscard]] virtual std::optional<AudioStreamId> new_stream(
+        const std::string &path,
+        bool loop
+    ) = 0;
 
-    bool init();
+    // Plays the stream from the start, restarting it if it is already playing.
+    virtual void play_stream(AudioStreamId id, float gain = 1.0f, float pan = 0.0f) = 0;
 
-    [[nodiscard]] std::optional<AudioSourceId> new_source_from_wav(const std::string &path);
+    virtual void stop_stream(AudioStreamId id) = 0;
 
-    void play(AudioSourceId id) const;
+    virtual void free_stream(AudioStreamId id) = 0;
 };
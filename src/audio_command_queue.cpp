@@ -0,0 +1,145 @@
+#include "audio_command_queue.hpp"
+
+#include <cassert>
+
+#include <spdlog/spdlog.h>
+
+AudioCommandQueue::AudioCommandQueue(size_t capacity)
+    : m_cells(std::make_unique<Cell[]>(capacity)), m_mask(capacity - 1)
+{
+    assert(capacity > 0 && (capacity & m_mask) == 0);
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+AudioVoiceId AudioCommandQueue::play(AudioSourceId source, float gain, float pan, float pitch)
+{
+    AudioVoiceId voice = m_next_voice.fetch_add(1, std::memory_order_relaxed);
+    push(AudioCommand{
+        .type = AudioCommandType::play,
+        .voice = voice,
+        .source = source,
+        .gain = gain,
+        .pan = pan,
+        .pitch = pitch,
+    });
+    return voice;
+}
+
+void AudioCommandQueue::stop(AudioVoiceId voice)
+{
+    push(AudioCommand{.type = AudioCommandType::stop, .voice = voice});
+}
+
+void AudioCommandQueue::set_voice_params(AudioVoiceId voice, float gain, float pan)
+{
+    push(AudioCommand{
+        .type = AudioCommandType::set_params,
+        .voice = voice,
+        .gain = gain,
+        .pan = pan,
+    });
+}
+
+void AudioCommandQueue::set_voice_pitch(AudioVoiceId voice, float pitch)
+{
+    push(AudioCommand{.type = AudioCommandType::set_pitch, .voice = voice, .pitch = pitch});
+}
+
+size_t AudioCommandQueue::apply(AudioMixer &mixer)
+{
+    return consume([&](const AudioCommand &command) {
+        if (command.type == AudioCommandType::play)
+        {
+            std::optional<AudioVoiceHandle> handle =
+                mixer.play(command.source, command.gain, command.pan, command.pitch);
+            if (handle)
+            {
+                m_voices[command.voice % VOICE_TABLE_SIZE] = VoiceSlot{
+                    .id = command.voice,
+                    .handle = *handle,
+                };
+            }
+            return;
+        }
+
+        // the mixer ignores handles of voices that finished or were stolen since
+        const AudioVoiceHandle *handle = find_voice(command.voice);
+        if (handle == nullptr)
+        {
+            return;
+        }
+        switch (command.type)
+        {
+        case AudioCommandType::stop:
+            mixer.stop(*handle);
+            break;
+        case AudioCommandType::set_params:
+            mixer.set_voice_params(*handle, command.gain, command.pan);
+            break;
+        case AudioCommandType::set_pitch:
+            mixer.set_voice_pitch(*handle, command.pitch);
+            break;
+        case AudioCommandType::play:
+            break;
+        }
+    });
+}
+
+void AudioCommandQueue::push(const AudioCommand &command)
+{
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    Cell *cell;
+    while (true)
+    {
+        cell = &m_cells[head & m_mask];
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(sequence - head);
+        if (diff == 0)
+        {
+            // claim the cell, another producer may have claimed it first
+            if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // the audio thread has not consumed the command a full lap ago yet
+            if (m_dropped.fetch_add(1, std::memory_order_relaxed) == 0)
+            {
+                spdlog::warn("AudioCommandQueue::push: queue is full, dropping commands");
+            }
+            return;
+        }
+        else
+        {
+            head = m_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->command = command;
+    cell->sequence.store(head + 1, std::memory_order_release);
+}
+
+bool AudioCommandQueue::pop(AudioCommand &command)
+{
+    Cell &cell = m_cells[m_tail & m_mask];
+    if (cell.sequence.load(std::memory_order_acquire) != m_tail + 1)
+    {
+        return false;
+    }
+
+    command = cell.command;
+    cell.sequence.store(m_tail + m_mask + 1, std::memory_order_release);
+    ++m_tail;
+    return true;
+}
+
+const AudioVoiceHandle *AudioCommandQueue::find_voice(AudioVoiceId voice) const
+{
+    const VoiceSlot &slot = m_voices[voice % VOICE_TABLE_SIZE];
+    return slot.id == voice ? &slot.handle : nullptr;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "audio.hpp"
+#include "audio_mixer.hpp"
+
+enum class AudioCommandType : uint8_t
+{
+    play,
+    stop,
+    set_params,
+    set_pitch,
+};
+
+struct AudioCommand
+{
+    AudioCommandType type{AudioCommandType::play};
+    AudioVoiceId voice{0};
+    AudioSourceId source{};
+    float gain{1.0f};
+    float pan{0.0f};
+    float pitch{1.0f};
+};
+
+// Bounded queue of voice commands that any number of threads push without locking or allocating,
+// and that the audio thread applies to its `AudioMixer` before mixing. Voice ids are handed out
+// when a sound is queued, so the sound can be stopped or changed before it has even started.
+class AudioCommandQueue
+{
+  public:
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+  private:
+    // Voices are looked up by id modulo the table size, so a voice only stops taking commands
+    // once this many newer sounds have been played while it still plays.
+    static constexpr size_t VOICE_TABLE_SIZE = 256;
+
+    struct Cell
+    {
+        // equal to the position the cell is next written at, one past it once written
+        std::atomic<uint64_t> sequence;
+        AudioCommand command;
+    };
+
+    struct VoiceSlot
+    {
+        AudioVoiceId id{0};
+        AudioVoiceHandle handle{};
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+    alignas(64) std::atomic<uint64_t> m_head{0};
+    std::atomic<uint32_t> m_next_voice{1};
+    std::atomic<uint64_t> m_dropped{0};
+
+    // only touched by the thread calling `apply`
+    alignas(64) uint64_t m_tail{0};
+    std::array<VoiceSlot, VOICE_TABLE_SIZE> m_voices{};
+
+    AudioCommandQueue(const AudioCommandQueue &) = delete;
+    AudioCommandQueue &operator=(const AudioCommandQueue &) = delete;
+    AudioCommandQueue(AudioCommandQueue &&) = delete;
+    AudioCommandQueue &operator=(AudioCommandQueue &&) = delete;
+
+  public:
+    // `capacity` must be a power of two
+    explicit AudioCommandQueue(size_t capacity = DEFAULT_CAPACITY);
+
+    // Any thread: commands that do not fit in a full queue are dropped and counted.
+    AudioVoiceId play(AudioSourceId source, float gain, float pan, float pitch);
+    void stop(AudioVoiceId voice);
+    void set_voice_params(AudioVoiceId voice, float gain, float pan);
+    void set_voice_pitch(AudioVoiceId voice, float pitch);
+
+    // Audio thread: applies the queued commands to `mixer` in the order they were pushed,
+    // returns how many there were.
+    size_t apply(AudioMixer &mixer);
+
+    // Audio thread: like `apply`, but hands every command to `f` instead of a mixer.
+    template<typename F>
+    size_t consume(F &&f)
+    {
+        size_t count = 0;
+        AudioCommand command;
+        while (pop(command))
+        {
+            ++count;
+            f(command);
+        }
+        return count;
+    }
+
+    [[nodiscard]] uint64_t get_dropped_count() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+  private:
+    void push(const AudioCommand &command);
+
+    [[nodiscard]] bool pop(AudioCommand &command);
+
+    [[nodiscard]] const AudioVoiceHandle *find_voice(AudioVoiceId voice) const;
+};
@@ -0,0 +1,259 @@
+#include "audio_mixer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
+
+namespace
+{
+
+// constant power panning, so a sound keeps the same loudness as it moves across the stereo field
+void get_pan_gains(float gain, float pan, float &left, float &right)
+{
+    float angle = (std::clamp(pan, -1.0f, 1.0f) + 1.0f) * glm::quarter_pi<float>();
+    left = gain * std::cos(angle);
+    right = gain * std::sin(angle);
+}
+
+// branch free over contiguous floats, which the compiler turns into SIMD
+void accumulate(
+    float *__restrict dst,
+    const float *__restrict src,
+    size_t frame_count,
+    float gain_left,
+    float gain_right
+)
+{
+    for (size_t i = 0; i < frame_count; ++i)
+    {
+        dst[i * 2] += src[i * 2] * gain_left;
+        dst[i * 2 + 1] += src[i * 2 + 1] * gain_right;
+    }
+}
+
+} // namespace
+
+AudioMixer::AudioMixer(uint32_t frequency) : m_frequency(frequency)
+{
+}
+
+AudioSourceId AudioMixer::add_sound(std::vector<float> samples)
+{
+    samples.resize(samples.size() - samples.size() % CHANNELS);
+    return m_sounds.insert(std::move(samples));
+}
+
+void AudioMixer::remove_sound(AudioSourceId sound)
+{
+    for (Voice &voice : m_voices)
+    {
+        if (voice.samples != nullptr && voice.sound == sound)
+        {
+            voice.samples = nullptr;
+        }
+    }
+    m_sounds.erase(sound);
+}
+
+std::optional<AudioVoiceHandle> AudioMixer::play(
+    AudioSourceId source, float gain, float pan, float pitch
+)
+{
+    const std::vector<float> *samples = m_sounds.find(source);
+    if (samples == nullptr)
+    {
+        return {};
+    }
+
+    auto voice = std::find_if(m_voices.begin(), m_voices.end(), [](const Voice &candidate) {
+        return candidate.samples == nullptr;
+    });
+    if (voice == m_voices.end())
+    {
+        voice = std::min_element(
+            m_voices.begin(),
+            m_voices.end(),
+            [](const Voice &a, const Voice &b) { return a.start_order < b.start_order; }
+        );
+    }
+
+    voice->sound = source;
+    voice->samples = samples->data();
+    voice->frame_count = samples->size() / CHANNELS;
+    voice->position = 0;
+    voice->phase = 0.0f;
+    voice->pitch = std::clamp(pitch, MIN_PITCH, MAX_PITCH);
+    voice->start_order = m_next_start_order++;
+    ++voice->generation;
+    get_pan_gains(gain, pan, voice->gain_left, voice->gain_right);
+
+    return AudioVoiceHandle{
+        .index = static_cast<uint32_t>(voice - m_voices.begin()),
+        .generation = voice->generation,
+    };
+}
+
+void AudioMixer::set_voice_params(AudioVoiceHandle voice, float gain, float pan)
+{
+    if (Voice *found = find_voice(voice))
+    {
+        get_pan_gains(gain, pan, found->gain_left, found->gain_right);
+    }
+}
+
+void AudioMixer::set_voice_pitch(AudioVoiceHandle voice, float pitch)
+{
+    if (Voice *found = find_voice(voice))
+    {
+        found->pitch = std::clamp(pitch, MIN_PITCH, MAX_PITCH);
+    }
+}
+
+void AudioMixer::stop(AudioVoiceHandle voice)
+{
+    if (Voice *found = find_voice(voice))
+    {
+        found->samples = nullptr;
+    }
+}
+
+bool AudioMixer::add_stream(SampleRing *ring, float gain, float pan)
+{
+    auto stream = std::find_if(m_streams.begin(), m_streams.end(), [](const Stream &candidate) {
+        return candidate.ring == nullptr;
+    });
+    if (stream == m_streams.end())
+    {
+        return false;
+    }
+
+    stream->ring = ring;
+    get_pan_gains(gain, pan, stream->gain_left, stream->gain_right);
+    return true;
+}
+
+void AudioMixer::remove_stream(const SampleRing *ring)
+{
+    for (Stream &stream : m_streams)
+    {
+        if (stream.ring == ring)
+        {
+            stream.ring = nullptr;
+        }
+    }
+}
+
+void AudioMixer::mix(std::span<float> output)
+{
+    std::fill(output.begin(), output.end(), 0.0f);
+    size_t frame_count = output.size() / CHANNELS;
+
+    for (Voice &voice : m_voices)
+    {
+        if (voice.samples == nullptr)
+        {
+            continue;
+        }
+        if (voice.pitch != 1.0f || voice.phase != 0.0f)
+        {
+            mix_resampled(voice, output.data(), frame_count);
+            continue;
+        }
+
+        size_t remaining = voice.frame_count - voice.position;
+        size_t count = std::min(frame_count, remaining);
+
+        const float *src = voice.samples + voice.position * CHANNELS;
+        accumulate(output.data(), src, count, voice.gain_left, voice.gain_right);
+
+        voice.position += count;
+        if (count == remaining)
+        {
+            voice.samples = nullptr;
+        }
+    }
+
+    for (Stream &stream : m_streams)
+    {
+        if (stream.ring == nullptr)
+        {
+            continue;
+        }
+
+        // an underrun leaves the rest of the output silent for this stream
+        size_t offset = 0;
+        for (std::span<const float> part : stream.ring->peek(output.size()))
+        {
+            size_t count = part.size() / CHANNELS;
+            float *dst = output.data() + offset;
+            accumulate(dst, part.data(), count, stream.gain_left, stream.gain_right);
+            offset += part.size();
+        }
+        stream.ring->consume(offset);
+
+        if (stream.ring->is_finished())
+        {
+            stream.ring = nullptr;
+        }
+    }
+
+    float master_gain = m_master_gain;
+    for (float &sample : output)
+    {
+        sample = std::clamp(sample * master_gain, -1.0f, 1.0f);
+    }
+}
+
+size_t AudioMixer::get_active_voice_count() const
+{
+    return static_cast<size_t>(std::count_if(m_voices.begin(), m_voices.end(), [](const auto &v) {
+        return v.samples != nullptr;
+    }));
+}
+
+size_t AudioMixer::get_active_stream_count() const
+{
+    return static_cast<size_t>(std::count_if(m_streams.begin(), m_streams.end(), [](const auto &s) {
+        return s.ring != nullptr;
+    }));
+}
+
+AudioMixer::Voice *AudioMixer::find_voice(AudioVoiceHandle voice)
+{
+    if (voice.index >= m_voices.size())
+    {
+        return nullptr;
+    }
+
+    Voice &found = m_voices[voice.index];
+    if (found.generation != voice.generation || found.samples == nullptr)
+    {
+        return nullptr;
+    }
+    return &found;
+}
+
+void AudioMixer::mix_resampled(Voice &voice, float *output, size_t frame_count)
+{
+    const float *src = voice.samples;
+    for (size_t i = 0; i < frame_count && voice.position < voice.frame_count; ++i)
+    {
+        // the last frame is held rather than interpolated towards silence
+        size_t next = std::min(voice.position + 1, voice.frame_count - 1);
+        const float *a = src + voice.position * CHANNELS;
+        const float *b = src + next * CHANNELS;
+        output[i * 2] += (a[0] + (b[0] - a[0]) * voice.phase) * voice.gain_left;
+        output[i * 2 + 1] += (a[1] + (b[1] - a[1]) * voice.phase) * voice.gain_right;
+
+        voice.phase += voice.pitch;
+        float frames = std::floor(voice.phase);
+        voice.position += static_cast<size_t>(frames);
+        voice.phase -= frames;
+    }
+
+    if (voice.position >= voice.frame_count)
+    {
+        voice.samples = nullptr;
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "audio.hpp"
+#include "sample_ring.hpp"
+#include "slot_map.hpp"
+
+struct AudioVoiceHandle
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+// Mixes a fixed pool of voices into interleaved stereo float samples. Sounds must already be
+// interleaved stereo floats at the mixer's frequency, so playing them never converts anything.
+// Long tracks are instead read from `SampleRing`s that another thread keeps filled. The mixer
+// does not touch an audio device and is not synchronized; the owner calls `mix` from the
+// device callback and makes sure no other call runs at the same time.
+class AudioMixer
+{
+  public:
+    static constexpr uint32_t CHANNELS = 2;
+    static constexpr size_t VOICE_COUNT = 32;
+    static constexpr size_t STREAM_COUNT = 4;
+    // playback rate of a voice relative to its sound, clamped to this range
+    static constexpr float MIN_PITCH = 0.125f;
+    static constexpr float MAX_PITCH = 8.0f;
+
+  private:
+    struct Voice
+    {
+        AudioSourceId sound;
+        // points into the sound's vector, which keeps its buffer when the slot map moves it
+        const float *samples{nullptr};
+        size_t frame_count{0};
+        size_t position{0};
+        // fraction of a frame past `position`, only non-zero while the pitch is not 1
+        float phase{0.0f};
+        float pitch{1.0f};
+        float gain_left{0.0f};
+        float gain_right{0.0f};
+        uint64_t start_order{0};
+        uint32_t generation{0};
+    };
+
+    struct Stream
+    {
+        SampleRing *ring{nullptr};
+        float gain_left{0.0f};
+        float gain_right{0.0f};
+    };
+
+    uint32_t m_frequency;
+    float m_master_gain{1.0f};
+
+    SlotMap<std::vector<float>> m_sounds;
+    std::array<Voice, VOICE_COUNT> m_voices{};
+    std::array<Stream, STREAM_COUNT> m_streams{};
+    uint64_t m_next_start_order{0};
+
+  public:
+    explicit AudioMixer(uint32_t frequency);
+
+    [[nodiscard]] AudioSourceId add_sound(std::vector<float> samples);
+
+    // stops every voice playing the sound, stale ids are ignored
+    void remove_sound(AudioSourceId sound);
+
+    // Starts `source` on a free voice, or steals the voice that has been playing the longest
+    // when all of them are busy. `pan` ranges from -1 (left) to 1 (right), a `pitch` of 2 plays
+    // the sound an octave higher and twice as fast. Returns nothing if `source` is stale.
+    std::optional<AudioVoiceHandle> play(
+        AudioSourceId source, float gain = 1.0f, float pan = 0.0f, float pitch = 1.0f
+    );
+
+    // Voice calls with a handle whose voice has finished or was stolen are ignored.
+    void set_voice_params(AudioVoiceHandle voice, float gain, float pan);
+
+    void set_voice_pitch(AudioVoiceHandle voice, float pitch);
+
+    void stop(AudioVoiceHandle voice);
+
+    // Mixes the samples of `ring` as they arrive until it is finished or removed, returns false
+    // when `STREAM_COUNT` streams are already playing. Streams are never stolen.
+    [[nodiscard]] bool add_stream(SampleRing *ring, float gain = 1.0f, float pan = 0.0f);
+
+    void remove_stream(const SampleRing *ring);
+
+    void set_master_gain(float gain)
+    {
+        m_master_gain = gain;
+    }
+
+    // Overwrites `output`, whose size must be a multiple of `CHANNELS`, with the next frames
+    // of every playing voice and stream.
+    void mix(std::span<float> output);
+
+    [[nodiscard]] uint32_t get_frequency() const
+    {
+        return m_frequency;
+    }
+
+    [[nodiscard]] size_t get_active_voice_count() const;
+
+    [[nodiscard]] size_t get_active_stream_count() const;
+
+  private:
+    [[nodiscard]] Voice *find_voice(AudioVoiceHandle voice);
+
+    // mixes a voice whose pitch is not 1 by interpolating between its frames
+    static void mix_resampled(Voice &voice, float *output, size_t frame_count);
+};
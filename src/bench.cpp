@@ -0,0 +1,2359 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <thread>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+
+#include <box2d/box2d.h>
+#include <entt/entt.hpp>
+#include <spdlog/spdlog.h>
+
+#include "asset_loader.hpp"
+#include "atlas_packer.hpp"
+#include "audio_command_queue.hpp"
+#include "audio_mixer.hpp"
+#include "command_buffer.hpp"
+#include "ecs.hpp"
+#include "frame_pacer.hpp"
+#include "input.hpp"
+#include "job_system.hpp"
+#include "level.hpp"
+#include "physics.hpp"
+#include "prefab.hpp"
+#include "slot_map.hpp"
+#include "spatial_grid.hpp"
+#include "sprite_batch.hpp"
+#include "sprite_culling.hpp"
+#include "streaming_source.hpp"
+#include "system_graph.hpp"
+#include "texture_atlas.hpp"
+#include "tilemap_collision.hpp"
+#include "upload_ring.hpp"
+
+class BenchTimer
+{
+    std::chrono::steady_clock::time_point m_start{std::chrono::steady_clock::now()};
+
+  public:
+    [[nodiscard]] double elapsed_ms() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start)
+            .count();
+    }
+};
+
+struct CoinWorld
+{
+    b2WorldId world_id;
+    b2BodyId player_id;
+    std::vector<b2BodyId> coin_ids;
+};
+
+static CoinWorld create_coin_world(size_t coin_count, bool sensors)
+{
+    b2WorldDef world_def = b2DefaultWorldDef();
+    world_def.gravity = b2Vec2{0.0f, 0.0f};
+
+    CoinWorld world{
+        .world_id = b2CreateWorld(&world_def),
+        .player_id = b2_nullBodyId,
+        .coin_ids = {},
+    };
+
+    size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(coin_count))));
+    for (size_t i = 0; i < coin_count; ++i)
+    {
+        b2BodyDef body_def = b2DefaultBodyDef();
+        body_def.position = b2Vec2{
+            static_cast<float>(i % columns) * 32.0f,
+            static_cast<float>(i / columns) * 32.0f,
+        };
+        b2BodyId body_id = b2CreateBody(world.world_id, &body_def);
+
+        b2ShapeDef shape_def = b2DefaultShapeDef();
+        shape_def.isSensor = sensors;
+        b2Circle circle{.center = b2Vec2{0.0f, 0.0f}, .radius = 8.0f};
+        b2CreateCircleShape(body_id, &shape_def, &circle);
+
+        world.coin_ids.push_back(body_id);
+    }
+
+    b2BodyDef player_def = b2DefaultBodyDef();
+    player_def.type = b2_dynamicBody;
+    player_def.position = b2Vec2{-32.0f, 0.0f};
+    player_def.linearVelocity = b2Vec2{400.0f, 0.0f};
+    world.player_id = b2CreateBody(world.world_id, &player_def);
+
+    b2ShapeDef player_shape_def = b2DefaultShapeDef();
+    b2Circle player_circle{.center = b2Vec2{0.0f, 0.0f}, .radius = 9.5f};
+    b2CreateCircleShape(world.player_id, &player_shape_def, &player_circle);
+
+    return world;
+}
+
+template<typename Query>
+static void run_coin_world(std::string_view method, size_t coin_count, bool sensors, Query query)
+{
+    constexpr int STEPS = 600;
+    constexpr float STEP = 1.0f / 120.0f;
+
+    CoinWorld world = create_coin_world(coin_count, sensors);
+    double step_ms = 0.0, query_ms = 0.0;
+    size_t hits = 0;
+    for (int step = 0; step < STEPS; ++step)
+    {
+        BenchTimer step_timer;
+        b2World_Step(world.world_id, STEP, 4);
+        step_ms += step_timer.elapsed_ms();
+
+        BenchTimer query_timer;
+        hits += query(world);
+        query_ms += query_timer.elapsed_ms();
+    }
+    b2DestroyWorld(world.world_id);
+
+    spdlog::info(
+        "bench coin_contacts: {:<8} {} coins: step {:.3f}ms, query {:.3f}ms per step, {} hits",
+        method,
+        coin_count,
+        step_ms / STEPS,
+        query_ms / STEPS,
+        hits
+    );
+}
+
+// Compares finding coins touched by the player by asking every coin body for its contacts,
+// as `Game::update` used to, with reading box2d's sensor begin events once per step.
+static bool bench_coin_contacts(size_t coin_count)
+{
+    run_coin_world("polling", coin_count, false, [](const CoinWorld &world) {
+        size_t hits = 0;
+        for (const auto &coin_id : world.coin_ids)
+        {
+            int capacity = b2Body_GetContactCapacity(coin_id);
+            if (capacity == 0)
+            {
+                continue;
+            }
+            std::vector<b2ContactData> datas(capacity, b2ContactData{});
+            int count = b2Body_GetContactData(coin_id, datas.data(), capacity);
+            std::vector<b2BodyId> bodies(count, b2_nullBodyId);
+            for (int i = 0; i < count; ++i)
+            {
+                bodies[i] = b2Shape_GetBody(datas[i].shapeIdA);
+            }
+            for (const auto &body_id : bodies)
+            {
+                if (B2_ID_EQUALS(body_id, world.player_id))
+                {
+                    ++hits;
+                    break;
+                }
+            }
+        }
+        return hits;
+    });
+
+    run_coin_world("events", coin_count, true, [](const CoinWorld &world) {
+        size_t hits = 0;
+        b2SensorEvents events = b2World_GetSensorEvents(world.world_id);
+        for (int i = 0; i < events.beginCount; ++i)
+        {
+            b2BodyId visitor_id = b2Shape_GetBody(events.beginEvents[i].visitorShapeId);
+            if (B2_ID_EQUALS(visitor_id, world.player_id))
+            {
+                ++hits;
+            }
+        }
+        return hits;
+    });
+
+    return true;
+}
+
+// Checks that `SpriteBatch` groups sprites of mixed pages and layers into one draw batch per used
+// page, in page order, keeping the order sprites were added in and their layer within a page, and
+// that a rebuilt batch does not keep pages from the previous frame.
+static bool check_sprite_batch()
+{
+    // the x position records the order sprites were added in, the z their layer
+    auto check = [](SpriteBatch &batch, std::span<const uint32_t> pages, std::string_view frame) {
+        batch.clear();
+        for (size_t i = 0; i < pages.size(); ++i)
+        {
+            batch.add(SpriteInstance{
+                .uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+                .position = glm::vec2(static_cast<float>(i), 0.0f),
+                .size = glm::vec2(16.0f, 16.0f),
+                .flipped = glm::vec2(0.0f, 0.0f),
+                .z = static_cast<float>(i % 3),
+                .page = pages[i],
+            });
+        }
+        batch.build();
+
+        const std::vector<SpriteInstance> &instances = batch.get_instances();
+        const std::vector<SpriteDrawBatch> &batches = batch.get_batches();
+        bool sorted = instances.size() == pages.size();
+        for (size_t i = 0; sorted && i < instances.size(); ++i)
+        {
+            auto added = static_cast<size_t>(instances[i].position.x);
+            sorted = instances[i].page == pages[added] &&
+                     instances[i].z == static_cast<float>(added % 3) &&
+                     (i == 0 || instances[i - 1].page < instances[i].page ||
+                      (instances[i - 1].page == instances[i].page &&
+                       instances[i - 1].position.x < instances[i].position.x));
+        }
+        if (!sorted)
+        {
+            spdlog::error("bench sprite_culling: {} sprites are not sorted by page", frame);
+            return false;
+        }
+
+        // one batch per used page, each covering exactly the run of sprites on its page
+        uint32_t next_instance = 0;
+        for (size_t i = 0; i < batches.size(); ++i)
+        {
+            const SpriteDrawBatch &draw = batches[i];
+            bool matches = draw.first_instance == next_instance && draw.instance_count > 0 &&
+                           (i == 0 || batches[i - 1].page < draw.page);
+            for (uint32_t j = 0; matches && j < draw.instance_count; ++j)
+            {
+                matches = instances[draw.first_instance + j].page == draw.page;
+            }
+            if (!matches)
+            {
+                spdlog::error(
+                    "bench sprite_culling: {} batch of page {} does not match its sprites",
+                    frame,
+                    draw.page
+                );
+                return false;
+            }
+            next_instance += draw.instance_count;
+        }
+        if (next_instance != instances.size())
+        {
+            spdlog::error("bench sprite_culling: {} batches leave sprites out", frame);
+            return false;
+        }
+        return true;
+    };
+
+    SpriteBatch batch;
+    const uint32_t first_pages[] = {3, 0, 3, 5, 0, 0, 5, 3, 1, 5, 0, 3};
+    const uint32_t second_pages[] = {1, 0, 1, 1, 0};
+    if (!check(batch, first_pages, "first frame") || !check(batch, second_pages, "second frame"))
+    {
+        return false;
+    }
+    if (batch.get_batches().size() != 2)
+    {
+        spdlog::error("bench sprite_culling: rebuilt batch kept pages of the previous frame");
+        return false;
+    }
+    return true;
+}
+
+static void run_sprite_culling(
+    std::string_view method, entt::registry &entities, size_t sprite_count, float level_size,
+    bool whole_level
+)
+{
+    constexpr int FRAMES = 200;
+    const glm::vec2 view_size(640.0f, 368.0f);
+
+    AtlasRegion region{.page = 0, .uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)};
+    auto resolve_texture = [&](TextureId) -> const AtlasRegion & { return region; };
+
+    std::vector<entt::entity> visible;
+    SpriteBatch batch;
+    double cull_ms = 0.0;
+    size_t drawn = 0;
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        // scroll diagonally across the level so the camera sees a different part every frame
+        float t = static_cast<float>(frame) / FRAMES;
+        Camera camera{
+            .position = whole_level ? glm::vec2(0.0f) : glm::vec2(t * (level_size - view_size.x)),
+            .size = whole_level ? glm::vec2(level_size) : view_size,
+        };
+
+        BenchTimer timer;
+        build_visible_sprites(entities, camera, resolve_texture, visible, batch);
+        cull_ms += timer.elapsed_ms();
+        drawn += batch.get_instances().size();
+    }
+
+    spdlog::info(
+        "bench sprite_culling: {:<8} {:>8} sprites: {:.3f}ms, {} sprites drawn per frame",
+        method,
+        sprite_count,
+        cull_ms / FRAMES,
+        drawn / FRAMES
+    );
+}
+
+// Checks `SpriteBatch`, then compares submitting every sprite of a level with culling against the
+// camera by testing every sprite and with querying the spatial grid, for levels of increasing size.
+static bool bench_sprite_culling(size_t max_sprite_count)
+{
+    if (!check_sprite_batch())
+    {
+        return false;
+    }
+
+    for (size_t sprite_count = std::max<size_t>(max_sprite_count / 100, 1);
+         sprite_count <= max_sprite_count;
+         sprite_count *= 10)
+    {
+        size_t columns =
+            static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(sprite_count))));
+        float level_size = std::max(static_cast<float>(columns) * 16.0f, 640.0f);
+
+        entt::registry entities;
+        for (size_t i = 0; i < sprite_count; ++i)
+        {
+            auto entity = entities.create();
+            entities.emplace<Transform>(
+                entity,
+                glm::vec2(static_cast<float>(i % columns), static_cast<float>(i / columns)) *
+                    16.0f
+            );
+            entities.emplace<Sprite>(entity, TextureId{}, glm::ivec2(16, 16));
+        }
+
+        run_sprite_culling("all", entities, sprite_count, level_size, true);
+        run_sprite_culling("linear", entities, sprite_count, level_size, false);
+
+        BenchTimer build_timer;
+        auto &grid = entities.ctx().emplace<SpatialGrid>(128.0f);
+        for (const auto [entity, transform, sprite] :
+             entities.view<const Transform, const Sprite>().each())
+        {
+            grid.insert(entity, get_sprite_bounds(transform, sprite));
+        }
+        double build_ms = build_timer.elapsed_ms();
+
+        run_sprite_culling("grid", entities, sprite_count, level_size, false);
+
+        // move a hundredth of the sprites by a pixel, as a frame of moving bodies would
+        BenchTimer update_timer;
+        size_t moved = 0;
+        for (auto [entity, transform, sprite] : entities.view<Transform, const Sprite>().each())
+        {
+            if (static_cast<size_t>(entt::to_entity(entity)) % 100 == 0)
+            {
+                transform.position.x += 1.0f;
+                grid.update(entity, get_sprite_bounds(transform, sprite));
+                ++moved;
+            }
+        }
+
+        spdlog::info(
+            "bench sprite_culling: grid     {:>8} sprites: built in {:.3f}ms, moved {} in {:.3f}ms",
+            sprite_count,
+            build_ms,
+            moved,
+            update_timer.elapsed_ms()
+        );
+    }
+
+    return true;
+}
+
+// Decodes the game's images on thread pools of increasing size, the way `Game::init` loads
+// them, to show how startup decode time scales with the number of cores.
+static bool bench_asset_decode(size_t image_count)
+{
+    static const char *paths[] = {
+        "./assets/knight.png",
+        "./assets/block.png",
+        "./assets/background.png",
+        "./assets/coin.png",
+    };
+
+    size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    double single_thread_ms = 0.0;
+    for (size_t thread_count = 1; thread_count <= max_threads; thread_count *= 2)
+    {
+        ThreadPool thread_pool(thread_count);
+        AssetLoader loader(&thread_pool);
+
+        BenchTimer timer;
+        std::vector<std::future<std::optional<ImageData>>> futures;
+        futures.reserve(image_count);
+        for (size_t i = 0; i < image_count; ++i)
+        {
+            futures.push_back(loader.load_image(paths[i % std::size(paths)]));
+        }
+
+        size_t pixels = 0;
+        for (auto &future : futures)
+        {
+            if (std::optional<ImageData> image = future.get())
+            {
+                pixels += static_cast<size_t>(image->width) * image->height;
+            }
+        }
+        double elapsed_ms = timer.elapsed_ms();
+        if (thread_count == 1)
+        {
+            single_thread_ms = elapsed_ms;
+        }
+
+        spdlog::info(
+            "bench asset_decode: {:>2} threads, {} images ({} pixels): {:.3f}ms, {:.2f}x",
+            thread_count,
+            image_count,
+            pixels,
+            elapsed_ms,
+            single_thread_ms / elapsed_ms
+        );
+    }
+
+    return true;
+}
+
+struct BenchPackedImage
+{
+    uint32_t page;
+    AtlasRect rect;
+};
+
+// Packs `image_count` images of seeded random sizes onto atlas pages the way `TextureAtlas` does,
+// twice, checking that both passes give the same layout and that no image leaves its page or
+// overlaps another, and that the pages are full enough for the images they hold.
+static bool bench_atlas_pack(size_t image_count)
+{
+    constexpr uint32_t PAGE_SIZE = TextureAtlas::PAGE_SIZE;
+    constexpr float MIN_OCCUPANCY = 0.8f;
+    std::mt19937 rng(1);
+    std::vector<std::pair<uint32_t, uint32_t>> sizes;
+    sizes.reserve(image_count);
+    double total_area = 0.0;
+    for (size_t i = 0; i < image_count; ++i)
+    {
+        // mostly sprites and tiles, with every 16th image a large background
+        uint32_t max_size = i % 16 == 15 ? 512 : 128;
+        const auto &[width, height] =
+            sizes.emplace_back(4 + rng() % (max_size - 3), 4 + rng() % (max_size - 3));
+        total_area += static_cast<double>(width) * height;
+    }
+
+    auto pack_all = [&](std::vector<AtlasPacker> &pages) {
+        std::vector<BenchPackedImage> packed;
+        packed.reserve(image_count);
+        for (const auto &[width, height] : sizes)
+        {
+            std::optional<AtlasRect> rect;
+            uint32_t page = 0;
+            for (; page < pages.size(); ++page)
+            {
+                rect = pages[page].pack(width, height);
+                if (rect)
+                {
+                    break;
+                }
+            }
+            if (!rect)
+            {
+                pages.emplace_back(PAGE_SIZE, PAGE_SIZE);
+                rect = pages.back().pack(width, height);
+            }
+            packed.push_back(BenchPackedImage{.page = page, .rect = *rect});
+        }
+        return packed;
+    };
+
+    std::vector<AtlasPacker> pages;
+    std::vector<BenchPackedImage> layouts[2];
+    for (auto &layout : layouts)
+    {
+        pages.clear();
+        BenchTimer timer;
+        layout = pack_all(pages);
+        spdlog::info(
+            "bench atlas_pack: packed {} images onto {} pages in {:.3f}ms",
+            image_count,
+            pages.size(),
+            timer.elapsed_ms()
+        );
+    }
+
+    for (size_t i = 0; i < image_count; ++i)
+    {
+        const BenchPackedImage &a = layouts[0][i];
+        const BenchPackedImage &b = layouts[1][i];
+        if (a.page != b.page || a.rect.x != b.rect.x || a.rect.y != b.rect.y)
+        {
+            spdlog::error("bench atlas_pack: image {} was placed differently the second time", i);
+            return false;
+        }
+    }
+
+    // marks the texels of every image, so overlapping images find theirs already taken
+    std::vector<std::vector<bool>> covered(pages.size());
+    for (size_t i = 0; i < image_count; ++i)
+    {
+        const auto &[page, rect] = layouts[0][i];
+        if (rect.width != sizes[i].first || rect.height != sizes[i].second ||
+            rect.x + rect.width > PAGE_SIZE || rect.y + rect.height > PAGE_SIZE)
+        {
+            spdlog::error("bench atlas_pack: image {} does not fit its rect on page {}", i, page);
+            return false;
+        }
+
+        std::vector<bool> &texels = covered[page];
+        texels.resize(static_cast<size_t>(PAGE_SIZE) * PAGE_SIZE);
+        for (uint32_t y = rect.y; y < rect.y + rect.height; ++y)
+        {
+            for (uint32_t x = rect.x; x < rect.x + rect.width; ++x)
+            {
+                if (texels[static_cast<size_t>(y) * PAGE_SIZE + x])
+                {
+                    spdlog::error("bench atlas_pack: image {} overlaps on page {}", i, page);
+                    return false;
+                }
+                texels[static_cast<size_t>(y) * PAGE_SIZE + x] = true;
+            }
+        }
+    }
+
+    // the last page is only filled as far as the images went
+    float total_occupancy = 0.0f;
+    float min_occupancy = 1.0f;
+    for (size_t page = 0; page + 1 < pages.size(); ++page)
+    {
+        total_occupancy += pages[page].get_occupancy();
+        min_occupancy = std::min(min_occupancy, pages[page].get_occupancy());
+    }
+    size_t full_pages = pages.size() - 1;
+    spdlog::info(
+        "bench atlas_pack: {} full pages {:.1f}% occupied on average, {:.1f}% at least, last page "
+        "{:.1f}%",
+        full_pages,
+        full_pages > 0 ? total_occupancy * 100.0f / static_cast<float>(full_pages) : 0.0f,
+        full_pages > 0 ? min_occupancy * 100.0f : 0.0f,
+        pages.back().get_occupancy() * 100.0f
+    );
+
+    if (full_pages > 0 && total_occupancy / static_cast<float>(full_pages) < MIN_OCCUPANCY)
+    {
+        spdlog::error(
+            "bench atlas_pack: full pages are less than {:.0f}% occupied on average",
+            MIN_OCCUPANCY * 100.0f
+        );
+        return false;
+    }
+    // every page but the last one holds at least `MIN_OCCUPANCY` of a page worth of texels
+    double page_area = static_cast<double>(PAGE_SIZE) * PAGE_SIZE;
+    auto max_pages = static_cast<size_t>(std::ceil(total_area / (page_area * MIN_OCCUPANCY))) + 1;
+    if (pages.size() > max_pages)
+    {
+        spdlog::error(
+            "bench atlas_pack: {} pages used where {} should hold all the images",
+            pages.size(),
+            max_pages
+        );
+        return false;
+    }
+
+    return true;
+}
+
+// Steps through a 1 KiB ring by hand and checks the offsets of allocations that are aligned, wrap
+// around the end, wait for submissions to be released in fence order and do not fit at all.
+static bool check_upload_ring_offsets()
+{
+    UploadRing ring(1024);
+    std::optional<uint64_t> offsets[8];
+    offsets[0] = ring.allocate(100);
+    offsets[1] = ring.allocate(100);
+    uint64_t first = ring.submit();
+    offsets[2] = ring.allocate(800);
+    uint64_t second = ring.submit();
+    // the ring is full until the first submission is released
+    offsets[3] = ring.allocate(16);
+    ring.release(first);
+    offsets[4] = ring.allocate(16);
+    offsets[5] = ring.allocate(300);
+    ring.release(second);
+    offsets[6] = ring.allocate(300);
+    // larger than the ring, `GPUUploadRing` gives these a buffer of their own
+    offsets[7] = ring.allocate(2048);
+    uint64_t third = ring.submit();
+    ring.release(second);
+    size_t used = ring.get_used();
+    ring.release(third);
+
+    const std::optional<uint64_t> expected[8] = {0, 112, 224, {}, 0, {}, 16, {}};
+    for (size_t i = 0; i < std::size(offsets); ++i)
+    {
+        if (offsets[i] != expected[i])
+        {
+            spdlog::error(
+                "bench upload_ring: allocation {} got offset {}, expected {}",
+                i,
+                offsets[i] ? static_cast<int64_t>(*offsets[i]) : -1,
+                expected[i] ? static_cast<int64_t>(*expected[i]) : -1
+            );
+            return false;
+        }
+    }
+    // releasing an older submission again must not give back the space of newer ones
+    if (used != 316 || ring.get_used() != 0 || ring.get_pending_submission_count() != 0)
+    {
+        spdlog::error("bench upload_ring: {} bytes in use after releasing out of order", used);
+        return false;
+    }
+
+    // a capacity that is not a power of two still wraps to the start of the next lap
+    UploadRing odd_ring(1000);
+    static_cast<void>(odd_ring.allocate(600, 8));
+    odd_ring.release(odd_ring.submit());
+    std::optional<uint64_t> wrapped = odd_ring.allocate(600, 8);
+    if (wrapped != 0 || odd_ring.get_used() != 1000)
+    {
+        spdlog::error(
+            "bench upload_ring: wrapping a 1000 byte ring gave offset {} with {} bytes in use",
+            wrapped ? static_cast<int64_t>(*wrapped) : -1,
+            odd_ring.get_used()
+        );
+        return false;
+    }
+    return true;
+}
+
+struct BenchUpload
+{
+    uint64_t submission_id;
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Uploads `upload_count` buffers of seeded random sizes through a 1 MiB ring the way
+// `GPUUploadRing` does, with the GPU releasing each frame's submission two frames later and
+// allocations waiting for the oldest submission when the ring is full. Checks that allocations are
+// aligned, inside the ring and never overlap one that is still in flight, then reports how often
+// uploads had to wait or did not fit, and the time per upload without the checks.
+static bool bench_upload_ring(size_t upload_count)
+{
+    constexpr uint64_t CAPACITY = 1024 * 1024;
+    constexpr uint64_t ALIGNMENT = 16;
+    constexpr size_t FRAMES_IN_FLIGHT = 2;
+
+    if (!check_upload_ring_offsets())
+    {
+        return false;
+    }
+
+    auto run = [&](bool check) {
+        UploadRing ring(CAPACITY);
+        std::deque<uint64_t> in_flight;
+        std::vector<BenchUpload> live;
+        std::mt19937 rng(1);
+        size_t waits = 0;
+        size_t dedicated = 0;
+
+        auto release_oldest = [&] {
+            ring.release(in_flight.front());
+            uint64_t released = in_flight.front();
+            in_flight.pop_front();
+            if (check)
+            {
+                std::erase_if(live, [&](const BenchUpload &upload) {
+                    return upload.submission_id <= released;
+                });
+            }
+        };
+
+        BenchTimer timer;
+        // submissions are numbered from 0 in the order they are submitted
+        uint64_t submission_id = 0;
+        for (size_t uploaded = 0; uploaded < upload_count;)
+        {
+            while (in_flight.size() >= FRAMES_IN_FLIGHT)
+            {
+                release_oldest();
+            }
+
+            size_t frame_uploads = 1 + rng() % 16;
+            for (size_t i = 0; i < frame_uploads && uploaded < upload_count; ++i, ++uploaded)
+            {
+                // from 16 bytes to 128 KiB, with the odd upload too large for the ring
+                uint64_t size = (16ull << rng() % 14) - rng() % 16;
+                if (rng() % 256 == 0)
+                {
+                    size = CAPACITY * 2;
+                }
+                std::optional<uint64_t> offset = ring.allocate(size, ALIGNMENT);
+                while (!offset && !in_flight.empty())
+                {
+                    ++waits;
+                    release_oldest();
+                    offset = ring.allocate(size, ALIGNMENT);
+                }
+                if (!offset)
+                {
+                    ++dedicated;
+                    continue;
+                }
+                if (!check)
+                {
+                    continue;
+                }
+
+                if (*offset % ALIGNMENT != 0 || *offset + size > CAPACITY)
+                {
+                    spdlog::error("bench upload_ring: {} bytes placed at {}", size, *offset);
+                    return false;
+                }
+                for (const BenchUpload &upload : live)
+                {
+                    if (*offset < upload.offset + upload.size && upload.offset < *offset + size)
+                    {
+                        spdlog::error(
+                            "bench upload_ring: {} bytes at {} overlap {} bytes at {} in flight",
+                            size,
+                            *offset,
+                            upload.size,
+                            upload.offset
+                        );
+                        return false;
+                    }
+                }
+                live.push_back(BenchUpload{
+                    .submission_id = submission_id,
+                    .offset = *offset,
+                    .size = size,
+                });
+            }
+
+            in_flight.push_back(ring.submit());
+            ++submission_id;
+        }
+
+        if (!check)
+        {
+            spdlog::info(
+                "bench upload_ring: {} uploads, {:.1f}ns per upload, {} waited for the GPU, {} "
+                "did not fit into the ring",
+                upload_count,
+                timer.elapsed_ms() * 1e6 / static_cast<double>(upload_count),
+                waits,
+                dedicated
+            );
+        }
+        return true;
+    };
+
+    return run(true) && run(false);
+}
+
+// Checks panning, gain, voice stealing and freeing of finished voices by mixing a constant sound.
+static bool check_audio_mixer()
+{
+    constexpr float LEVEL = 0.5f;
+    constexpr float EPSILON = 1e-5f;
+    constexpr size_t FRAMES = 16;
+
+    AudioMixer mixer(48000);
+    AudioSourceId level = mixer.add_sound(std::vector<float>(1000 * AudioMixer::CHANNELS, LEVEL));
+    AudioSourceId silence = mixer.add_sound(std::vector<float>(1000 * AudioMixer::CHANNELS, 0.0f));
+    std::vector<float> output(FRAMES * AudioMixer::CHANNELS);
+    auto mix_first_frame = [&](float &left, float &right) {
+        mixer.mix(output);
+        left = output[0];
+        right = output[1];
+    };
+
+    // constant power: the squared gains always add up to the squared gain
+    for (float pan : {-1.0f, -0.5f, 0.0f, 0.3f, 1.0f})
+    {
+        for (float gain : {1.0f, 0.5f})
+        {
+            std::optional<AudioVoiceHandle> voice = mixer.play(level, gain, pan);
+            float left = 0.0f;
+            float right = 0.0f;
+            mix_first_frame(left, right);
+            mixer.stop(*voice);
+
+            float power = left * left + right * right;
+            float expected = LEVEL * LEVEL * gain * gain;
+            bool hard_left = pan == -1.0f && (std::abs(left - LEVEL * gain) > EPSILON ||
+                                              std::abs(right) > EPSILON);
+            if (std::abs(power - expected) > EPSILON || hard_left)
+            {
+                spdlog::error(
+                    "bench audio_mix: pan {} gain {} mixed to {} left, {} right",
+                    pan,
+                    gain,
+                    left,
+                    right
+                );
+                return false;
+            }
+        }
+    }
+
+    // with every voice busy the oldest one is stolen, and its old handle no longer reaches it
+    std::optional<AudioVoiceHandle> oldest = mixer.play(silence);
+    for (size_t i = 1; i < AudioMixer::VOICE_COUNT; ++i)
+    {
+        static_cast<void>(mixer.play(silence));
+    }
+    std::optional<AudioVoiceHandle> stealer = mixer.play(level, 1.0f, -1.0f);
+    mixer.set_voice_params(*oldest, 0.0f, 0.0f);
+    mixer.stop(*oldest);
+    float left = 0.0f;
+    float right = 0.0f;
+    mix_first_frame(left, right);
+    if (stealer->index != oldest->index ||
+        mixer.get_active_voice_count() != AudioMixer::VOICE_COUNT ||
+        std::abs(left - LEVEL) > EPSILON)
+    {
+        spdlog::error(
+            "bench audio_mix: voice {} was stolen instead of the oldest voice {}, or its old "
+            "handle changed it",
+            stealer->index,
+            oldest->index
+        );
+        return false;
+    }
+
+    // a sound shorter than a buffer frees its voice once it is done and leaves silence after it
+    AudioMixer short_mixer(48000);
+    AudioSourceId short_sound =
+        short_mixer.add_sound(std::vector<float>(10 * AudioMixer::CHANNELS, LEVEL));
+    static_cast<void>(short_mixer.play(short_sound, 1.0f, -1.0f));
+    short_mixer.mix(output);
+    if (short_mixer.get_active_voice_count() != 0 || std::abs(output[9 * 2] - LEVEL) > EPSILON ||
+        output[10 * 2] != 0.0f)
+    {
+        spdlog::error("bench audio_mix: a finished voice was not freed");
+        return false;
+    }
+    return true;
+}
+
+// Checks the mixer's voices, then mixes `seconds` of audio in 10ms buffers with every voice of the
+// mixer busy, without an audio device, and reports how much faster than real time that is.
+static bool bench_audio_mix(size_t seconds)
+{
+    if (!check_audio_mixer())
+    {
+        return false;
+    }
+
+    constexpr uint32_t frequency = 48000;
+    constexpr size_t buffer_frames = frequency / 100;
+
+    AudioMixer mixer(frequency);
+    std::vector<float> samples(frequency * AudioMixer::CHANNELS);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = std::sin(static_cast<float>(i) * 0.01f) * 0.1f;
+    }
+    AudioSourceId source = mixer.add_sound(std::move(samples));
+
+    std::vector<float> output(buffer_frames * AudioMixer::CHANNELS);
+    size_t buffer_count = seconds * 100;
+
+    BenchTimer timer;
+    for (size_t buffer = 0; buffer < buffer_count; ++buffer)
+    {
+        while (mixer.get_active_voice_count() < AudioMixer::VOICE_COUNT)
+        {
+            float pan = static_cast<float>(buffer % 21) / 10.0f - 1.0f;
+            mixer.play(source, 0.5f, pan);
+        }
+        mixer.mix(output);
+    }
+    double elapsed_ms = timer.elapsed_ms();
+
+    spdlog::info(
+        "bench audio_mix: {} voices, {}s of audio: {:.3f}ms, {:.4f}ms per 10ms buffer, {:.0f}x "
+        "real time",
+        AudioMixer::VOICE_COUNT,
+        seconds,
+        elapsed_ms,
+        elapsed_ms / static_cast<double>(buffer_count),
+        static_cast<double>(seconds) * 1000.0 / elapsed_ms
+    );
+
+    return true;
+}
+
+struct BenchSound
+{
+    AudioSourceId source;
+};
+
+// Triggers `count` sounds in frames of 64, each through an entity with a sound component that a
+// view plays and destroys, as the game used to, and through an `AudioCommandQueue` that is
+// drained after every frame as the audio callback would. Then several threads push commands at
+// once while this one drains them, into queues of the default size, of part of a frame and with
+// room for all of them.
+static bool bench_audio_commands(size_t count)
+{
+    constexpr size_t SOUNDS_PER_FRAME = 64;
+    AudioMixer mixer(48000);
+    AudioSourceId source = mixer.add_sound(std::vector<float>(4800 * AudioMixer::CHANNELS, 0.1f));
+
+    auto report = [&](std::string_view method, double elapsed_ms, uint64_t dropped) {
+        spdlog::info(
+            "bench audio_commands: {:<8} {} sounds: {:.3f}ms, {:.1f}ns per sound, {} dropped",
+            method,
+            count,
+            elapsed_ms,
+            elapsed_ms * 1e6 / static_cast<double>(count),
+            dropped
+        );
+    };
+
+    {
+        entt::registry registry;
+        BenchTimer timer;
+        for (size_t played = 0; played < count; played += SOUNDS_PER_FRAME)
+        {
+            for (size_t i = played; i < std::min(played + SOUNDS_PER_FRAME, count); ++i)
+            {
+                registry.emplace<BenchSound>(registry.create(), source);
+            }
+            for (const auto [entity, sound] : registry.view<const BenchSound>().each())
+            {
+                mixer.play(sound.source);
+                registry.destroy(entity);
+            }
+        }
+        report("entities", timer.elapsed_ms(), 0);
+    }
+
+    AudioCommandQueue queue;
+    size_t applied = 0;
+    BenchTimer timer;
+    for (size_t played = 0; played < count; played += SOUNDS_PER_FRAME)
+    {
+        for (size_t i = played; i < std::min(played + SOUNDS_PER_FRAME, count); ++i)
+        {
+            AudioVoiceId voice = queue.play(source, 1.0f, 0.0f, 1.0f);
+            queue.set_voice_pitch(voice, 1.5f);
+        }
+        applied += queue.apply(mixer);
+    }
+    report("queue", timer.elapsed_ms(), queue.get_dropped_count());
+
+    if (applied != count * 2)
+    {
+        spdlog::error("bench audio_commands: applied {} of {} commands", applied, count * 2);
+        return false;
+    }
+
+    // producers tag their commands with their index as the gain and a sequence number as the
+    // voice, so this thread can tell whether each one arrived once and in order or was dropped
+    constexpr size_t PRODUCERS = 4;
+    auto run_producers = [&](std::string_view method, size_t capacity) {
+        AudioCommandQueue shared_queue(capacity);
+        size_t per_producer = count / PRODUCERS;
+        std::atomic<size_t> finished{0};
+        std::vector<std::thread> producers;
+        BenchTimer producer_timer;
+        for (size_t producer = 0; producer < PRODUCERS; ++producer)
+        {
+            producers.emplace_back([&, producer] {
+                for (size_t i = 0; i < per_producer; ++i)
+                {
+                    shared_queue.set_voice_params(
+                        static_cast<AudioVoiceId>(i), static_cast<float>(producer), 0.0f
+                    );
+                    // a frame's worth of sounds between the producers, then let the others run
+                    if (i % (SOUNDS_PER_FRAME / PRODUCERS) == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                finished.fetch_add(1, std::memory_order_release);
+            });
+        }
+
+        std::array<size_t, PRODUCERS> received{};
+        std::array<size_t, PRODUCERS> next_sequence{};
+        bool ordered = true;
+        auto check = [&](const AudioCommand &command) {
+            auto producer = static_cast<size_t>(command.gain);
+            if (producer >= PRODUCERS || command.voice < next_sequence[producer])
+            {
+                ordered = false;
+                return;
+            }
+            next_sequence[producer] = command.voice + 1;
+            ++received[producer];
+        };
+        while (true)
+        {
+            // everything pushed before the producers finished is drained by the last pass
+            bool done = finished.load(std::memory_order_acquire) == PRODUCERS;
+            size_t consumed = shared_queue.consume(check);
+            if (done)
+            {
+                break;
+            }
+            if (consumed == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        for (std::thread &thread : producers)
+        {
+            thread.join();
+        }
+        report(method, producer_timer.elapsed_ms(), shared_queue.get_dropped_count());
+
+        size_t total = 0;
+        for (size_t producer_received : received)
+        {
+            total += producer_received;
+        }
+        if (!ordered)
+        {
+            spdlog::error("bench audio_commands: {} commands came twice or out of order", method);
+            return false;
+        }
+        // with room for every command none may be dropped, so each one arrived exactly once
+        size_t pushed = per_producer * PRODUCERS;
+        uint64_t dropped = shared_queue.get_dropped_count();
+        if (total + dropped != pushed || (capacity >= pushed && dropped != 0))
+        {
+            spdlog::error(
+                "bench audio_commands: {} received {} and dropped {} of {} commands",
+                method,
+                total,
+                dropped,
+                pushed
+            );
+            return false;
+        }
+        return true;
+    };
+
+    // a queue that only holds part of a frame drops commands, which must all be counted
+    return run_producers("threads", AudioCommandQueue::DEFAULT_CAPACITY) &&
+           run_producers("crowded", SOUNDS_PER_FRAME / PRODUCERS) &&
+           run_producers("roomy", std::bit_ceil(std::max<size_t>(count, 1)));
+}
+
+// Writes `frame_count` frames of a 16 bit mono sine wave as a WAV file.
+static bool write_test_wav(const std::string &path, uint32_t frequency, uint32_t frame_count)
+{
+    std::ofstream out(path, std::ios::binary);
+    auto write_u16 = [&](uint16_t value) {
+        const uint8_t bytes[] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+        out.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+    };
+    auto write_u32 = [&](uint32_t value) {
+        write_u16(static_cast<uint16_t>(value));
+        write_u16(static_cast<uint16_t>(value >> 16));
+    };
+
+    uint32_t data_size = frame_count * sizeof(int16_t);
+    out.write("RIFF", 4);
+    write_u32(36 + data_size);
+    out.write("WAVEfmt ", 8);
+    write_u32(16);
+    write_u16(1);
+    write_u16(1);
+    write_u32(frequency);
+    write_u32(frequency * sizeof(int16_t));
+    write_u16(sizeof(int16_t));
+    write_u16(16);
+    out.write("data", 4);
+    write_u32(data_size);
+
+    std::vector<int16_t> samples(frequency);
+    for (uint32_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = static_cast<int16_t>(std::sin(static_cast<float>(i) * 0.05f) * 8000.0f);
+    }
+    for (uint32_t written = 0; written < frame_count; written += frequency)
+    {
+        uint32_t count = std::min(frequency, frame_count - written);
+        out.write(
+            reinterpret_cast<const char *>(samples.data()),
+            static_cast<std::streamsize>(count * sizeof(int16_t))
+        );
+    }
+    return out.good();
+}
+
+// Streams a generated track of `seconds` of 44.1 kHz mono audio as fast as the background thread
+// converts it to 48 kHz stereo, and checks that all of it arrives through buffers whose size does
+// not depend on the length of the track.
+static bool bench_audio_stream(size_t seconds)
+{
+    constexpr uint32_t file_frequency = 44100;
+    constexpr uint32_t mixer_frequency = 48000;
+
+    std::string path = (std::filesystem::temp_directory_path() / "platformer_stream.wav").string();
+    uint32_t frame_count = static_cast<uint32_t>(seconds) * file_frequency;
+    if (!write_test_wav(path, file_frequency, frame_count))
+    {
+        spdlog::error("bench audio_stream: failed to write {}", path);
+        return false;
+    }
+
+    bool complete = true;
+    {
+        StreamingSource source(mixer_frequency);
+        if (!source.open(path, false))
+        {
+            return false;
+        }
+
+        BenchTimer timer;
+        if (!source.start())
+        {
+            return false;
+        }
+
+        SampleRing &ring = source.get_ring();
+        size_t max_buffered = 0;
+        uint64_t samples = 0;
+        while (!ring.is_finished())
+        {
+            max_buffered = std::max(max_buffered, ring.get_size());
+            size_t count = 0;
+            for (std::span<const float> part : ring.peek(ring.get_capacity()))
+            {
+                count += part.size();
+            }
+            ring.consume(count);
+            samples += count;
+            if (count == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        double elapsed_ms = timer.elapsed_ms();
+
+        uint64_t expected = static_cast<uint64_t>(frame_count) * mixer_frequency / file_frequency;
+        uint64_t frames = samples / AudioMixer::CHANNELS;
+        spdlog::info(
+            "bench audio_stream: {}s track ({:.1f} MiB): {:.3f}ms, {:.0f}x real time, {} of {} "
+            "frames, at most {} samples buffered, {} KiB of buffers",
+            seconds,
+            static_cast<double>(frame_count * sizeof(int16_t)) / (1024.0 * 1024.0),
+            elapsed_ms,
+            static_cast<double>(seconds) * 1000.0 / elapsed_ms,
+            frames,
+            expected,
+            max_buffered,
+            source.get_buffer_size() / 1024
+        );
+        // the resampler may hold back a few frames of filter history
+        if (frames + mixer_frequency / 100 < expected || frames > expected + 1)
+        {
+            spdlog::error("bench audio_stream: streamed {} frames, expected {}", frames, expected);
+            complete = false;
+        }
+    }
+
+    std::filesystem::remove(path);
+    return complete;
+}
+
+// Inserts, looks up, iterates and erases `count` atlas regions in a `SlotMap` and, as a
+// baseline, in an `std::unordered_map` keyed by an incrementing id. Half of the values are erased
+// and inserted again to show that freed slots are reused.
+static bool bench_slot_map(size_t count)
+{
+    std::mt19937 rng(1);
+    const AtlasRegion region{.page = 1, .uv_rect = glm::vec4(0.0f)};
+
+    auto report = [&](std::string_view container, std::string_view op, double elapsed_ms) {
+        spdlog::info(
+            "bench slot_map: {:<13} {:<8} {} values: {:.3f}ms, {:.1f}ns per value",
+            container,
+            op,
+            count,
+            elapsed_ms,
+            elapsed_ms * 1e6 / static_cast<double>(count)
+        );
+    };
+
+    {
+        SlotMap<AtlasRegion> slot_map;
+        std::vector<SlotMapHandle> handles;
+        handles.reserve(count);
+
+        BenchTimer insert_timer;
+        for (size_t i = 0; i < count; ++i)
+        {
+            handles.push_back(slot_map.insert(region));
+        }
+        report("SlotMap", "insert", insert_timer.elapsed_ms());
+
+        std::vector<SlotMapHandle> lookups = handles;
+        std::shuffle(lookups.begin(), lookups.end(), rng);
+        uint64_t pages = 0;
+        BenchTimer lookup_timer;
+        for (SlotMapHandle handle : lookups)
+        {
+            pages += slot_map.get(handle).page;
+        }
+        report("SlotMap", "lookup", lookup_timer.elapsed_ms());
+
+        BenchTimer iterate_timer;
+        for (const AtlasRegion &value : slot_map.get_values())
+        {
+            pages += value.page;
+        }
+        report("SlotMap", "iterate", iterate_timer.elapsed_ms());
+
+        BenchTimer erase_timer;
+        for (SlotMapHandle handle : lookups)
+        {
+            slot_map.erase(handle);
+        }
+        report("SlotMap", "erase", erase_timer.elapsed_ms());
+
+        size_t stale = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            SlotMapHandle handle = slot_map.insert(region);
+            stale += slot_map.contains(handles[i]) || slot_map.find(handles[i]) != nullptr;
+            if (handle.index >= count)
+            {
+                spdlog::error("bench slot_map: slot {} was not reused", handle.index);
+                return false;
+            }
+        }
+        spdlog::info(
+            "bench slot_map: reinserted {} values into freed slots, {} stale handles resolved, "
+            "checksum {}",
+            count,
+            stale,
+            pages
+        );
+        if (stale != 0)
+        {
+            spdlog::error("bench slot_map: handles to erased values found their replacements");
+            return false;
+        }
+    }
+
+    {
+        std::unordered_map<uint64_t, AtlasRegion> map;
+        std::vector<uint64_t> keys;
+        keys.reserve(count);
+
+        BenchTimer insert_timer;
+        for (size_t i = 0; i < count; ++i)
+        {
+            keys.push_back(i);
+            map.emplace(i, region);
+        }
+        report("unordered_map", "insert", insert_timer.elapsed_ms());
+
+        std::shuffle(keys.begin(), keys.end(), rng);
+        uint64_t pages = 0;
+        BenchTimer lookup_timer;
+        for (uint64_t key : keys)
+        {
+            pages += map.at(key).page;
+        }
+        report("unordered_map", "lookup", lookup_timer.elapsed_ms());
+
+        BenchTimer iterate_timer;
+        for (const auto &[key, value] : map)
+        {
+            pages += value.page;
+        }
+        report("unordered_map", "iterate", iterate_timer.elapsed_ms());
+
+        BenchTimer erase_timer;
+        for (uint64_t key : keys)
+        {
+            map.erase(key);
+        }
+        report("unordered_map", "erase", erase_timer.elapsed_ms());
+        spdlog::info("bench slot_map: unordered_map checksum {}", pages);
+    }
+
+    return true;
+}
+
+// Parses a generated `size` x `size` level with a solid and a decoration layer and a coin on
+// about every 64th tile, from text and from the binary form it converts to, and checks that
+// both give the same level.
+static bool bench_level_parse(size_t size)
+{
+    uint32_t side = static_cast<uint32_t>(size);
+    size_t tile_count = static_cast<size_t>(side) * side;
+    std::mt19937 rng(1);
+
+    Level level{
+        .width = side,
+        .height = side,
+        .layers = {},
+        .spawns = {},
+        .solid_layer = 0,
+    };
+    for (std::string_view name : {"solid", "decoration"})
+    {
+        LevelLayer &layer = level.layers.emplace_back(LevelLayer{
+            .name = std::string(name),
+            .tiles = std::vector<LevelTile>(tile_count),
+        });
+        for (LevelTile &tile : layer.tiles)
+        {
+            tile = rng() % 4 == 0 ? LevelTile::block : LevelTile::empty;
+        }
+    }
+    level.spawns.push_back(LevelSpawn{.type = LevelSpawnType::player, .x = 0, .y = 0});
+    for (uint32_t y = 0; y < side; ++y)
+    {
+        for (uint32_t x = 0; x < side; ++x)
+        {
+            if (rng() % 64 == 0 && level.get_solid_tile(x, y) == LevelTile::empty)
+            {
+                level.spawns.push_back(LevelSpawn{.type = LevelSpawnType::coin, .x = x, .y = y});
+            }
+        }
+    }
+
+    std::string text = write_level_text(level);
+    std::vector<uint8_t> binary = write_level_binary(level);
+
+    auto report = [&](std::string_view format, size_t bytes, double elapsed_ms) {
+        spdlog::info(
+            "bench level_parse: {}x{} {:<6} ({:.1f} MiB): {:.3f}ms, {:.0f} MiB/s",
+            side,
+            side,
+            format,
+            static_cast<double>(bytes) / (1024.0 * 1024.0),
+            elapsed_ms,
+            static_cast<double>(bytes) / (1024.0 * 1024.0) / (elapsed_ms / 1000.0)
+        );
+    };
+
+    BenchTimer text_timer;
+    std::optional<Level> from_text = parse_level_text(text);
+    report("text", text.size(), text_timer.elapsed_ms());
+
+    BenchTimer binary_timer;
+    std::optional<Level> from_binary = parse_level_binary(binary);
+    report("binary", binary.size(), binary_timer.elapsed_ms());
+
+    auto same_level = [&](const std::optional<Level> &parsed) {
+        return parsed && parsed->layers.size() == level.layers.size() &&
+               parsed->spawns.size() == level.spawns.size() &&
+               std::equal(
+                   level.layers.begin(),
+                   level.layers.end(),
+                   parsed->layers.begin(),
+                   [](const LevelLayer &a, const LevelLayer &b) {
+                       return a.name == b.name && a.tiles == b.tiles;
+                   }
+               ) &&
+               std::equal(
+                   level.spawns.begin(),
+                   level.spawns.end(),
+                   parsed->spawns.begin(),
+                   [](const LevelSpawn &a, const LevelSpawn &b) {
+                       return a.type == b.type && a.x == b.x && a.y == b.y;
+                   }
+               );
+    };
+    if (!same_level(from_text) || !same_level(from_binary))
+    {
+        spdlog::error("bench level_parse: parsed level does not match the generated one");
+        return false;
+    }
+
+    return true;
+}
+
+// Checks that the rects merged from a grid cover every solid cell exactly once and nothing else.
+static bool check_merged_tiles(
+    uint32_t width, uint32_t height, std::span<const uint8_t> solid, std::span<const TileRect> rects
+)
+{
+    std::vector<uint8_t> covered(solid.size(), 0);
+    for (const TileRect &rect : rects)
+    {
+        if (rect.width == 0 || rect.height == 0 || rect.x + rect.width > width ||
+            rect.y + rect.height > height)
+        {
+            spdlog::error("bench tile_merge: rect at {},{} leaves the grid", rect.x, rect.y);
+            return false;
+        }
+        for (uint32_t y = rect.y; y < rect.y + rect.height; ++y)
+        {
+            for (uint32_t x = rect.x; x < rect.x + rect.width; ++x)
+            {
+                size_t idx = static_cast<size_t>(y) * width + x;
+                if (solid[idx] == 0 || covered[idx] != 0)
+                {
+                    spdlog::error(
+                        "bench tile_merge: cell {},{} of a {}x{} grid is {}",
+                        x,
+                        y,
+                        width,
+                        height,
+                        solid[idx] == 0 ? "empty but covered" : "covered twice"
+                    );
+                    return false;
+                }
+                covered[idx] = 1;
+            }
+        }
+    }
+
+    if (covered != std::vector<uint8_t>(solid.begin(), solid.end()))
+    {
+        spdlog::error("bench tile_merge: {}x{} grid has uncovered solid cells", width, height);
+        return false;
+    }
+    if (rects.size() > static_cast<size_t>(std::count(solid.begin(), solid.end(), 1)))
+    {
+        spdlog::error("bench tile_merge: {}x{} grid has more rects than cells", width, height);
+        return false;
+    }
+    return true;
+}
+
+// Merges the solid cells of seeded random grids, checking the rects of many small grids and of
+// `size` x `size` grids with 10%, 50% and 90% solid cells. For the large grids it reports how many
+// box2d bodies and shapes a static body per tile takes against one body with a box per rect.
+static bool bench_tile_merge(size_t size)
+{
+    std::mt19937 rng(1);
+    auto random_grid = [&](uint32_t width, uint32_t height, uint32_t solid_percent) {
+        std::vector<uint8_t> solid(static_cast<size_t>(width) * height);
+        for (uint8_t &cell : solid)
+        {
+            cell = rng() % 100 < solid_percent ? 1 : 0;
+        }
+        return solid;
+    };
+
+    for (uint32_t width = 1; width <= 16; ++width)
+    {
+        for (uint32_t height = 1; height <= 16; ++height)
+        {
+            for (uint32_t solid_percent : {10u, 50u, 90u, 100u})
+            {
+                std::vector<uint8_t> solid = random_grid(width, height, solid_percent);
+                if (!check_merged_tiles(
+                        width, height, solid, merge_solid_tiles(width, height, solid)
+                    ))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    // a solid block is a single rect, the walls of a hollow room are one rect each
+    for (uint32_t width = 3; width <= 16; ++width)
+    {
+        for (uint32_t height = 3; height <= 16; ++height)
+        {
+            std::vector<uint8_t> block(static_cast<size_t>(width) * height, 1);
+            std::vector<uint8_t> room(block.size(), 0);
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    bool wall = x == 0 || y == 0 || x == width - 1 || y == height - 1;
+                    room[static_cast<size_t>(y) * width + x] = wall ? 1 : 0;
+                }
+            }
+
+            std::vector<TileRect> block_rects = merge_solid_tiles(width, height, block);
+            std::vector<TileRect> room_rects = merge_solid_tiles(width, height, room);
+            if (!check_merged_tiles(width, height, block, block_rects) ||
+                !check_merged_tiles(width, height, room, room_rects))
+            {
+                return false;
+            }
+            if (block_rects.size() != 1 || room_rects.size() != 4)
+            {
+                spdlog::error(
+                    "bench tile_merge: {}x{} block and room merged into {} and {} rects, not 1 "
+                    "and 4",
+                    width,
+                    height,
+                    block_rects.size(),
+                    room_rects.size()
+                );
+                return false;
+            }
+        }
+    }
+
+    uint32_t grid_size = static_cast<uint32_t>(size);
+    for (uint32_t solid_percent : {10u, 50u, 90u})
+    {
+        std::vector<uint8_t> solid = random_grid(grid_size, grid_size, solid_percent);
+        BenchTimer merge_timer;
+        std::vector<TileRect> rects = merge_solid_tiles(grid_size, grid_size, solid);
+        double merge_ms = merge_timer.elapsed_ms();
+        if (!check_merged_tiles(grid_size, grid_size, solid, rects))
+        {
+            return false;
+        }
+
+        b2WorldDef world_def = b2DefaultWorldDef();
+        b2BodyDef body_def = b2DefaultBodyDef();
+        b2ShapeDef shape_def = b2DefaultShapeDef();
+        auto add_box = [&](b2BodyId body_id, const TileRect &rect) {
+            b2Polygon polygon = b2MakeOffsetBox(
+                static_cast<float>(rect.width) / 2.0f,
+                static_cast<float>(rect.height) / 2.0f,
+                b2Vec2{
+                    static_cast<float>(rect.x) + static_cast<float>(rect.width) / 2.0f,
+                    -static_cast<float>(rect.y) - static_cast<float>(rect.height) / 2.0f,
+                },
+                0.0f
+            );
+            b2CreatePolygonShape(body_id, &shape_def, &polygon);
+        };
+        auto report = [&](std::string_view method, b2WorldId world_id, double elapsed_ms) {
+            b2Counts counts = b2World_GetCounts(world_id);
+            spdlog::info(
+                "bench tile_merge: {}x{} grid, {}% solid, {:<8} {} bodies, {} shapes, built in "
+                "{:.3f}ms",
+                grid_size,
+                grid_size,
+                solid_percent,
+                method,
+                counts.bodyCount,
+                counts.shapeCount,
+                elapsed_ms
+            );
+            b2DestroyWorld(world_id);
+        };
+
+        b2WorldId tile_world_id = b2CreateWorld(&world_def);
+        BenchTimer tile_timer;
+        for (uint32_t y = 0; y < grid_size; ++y)
+        {
+            for (uint32_t x = 0; x < grid_size; ++x)
+            {
+                if (solid[static_cast<size_t>(y) * grid_size + x] != 0)
+                {
+                    b2BodyId body_id = b2CreateBody(tile_world_id, &body_def);
+                    add_box(body_id, TileRect{.x = x, .y = y, .width = 1, .height = 1});
+                }
+            }
+        }
+        report("per tile", tile_world_id, tile_timer.elapsed_ms());
+
+        b2WorldId merged_world_id = b2CreateWorld(&world_def);
+        BenchTimer merged_timer;
+        b2BodyId body_id = b2CreateBody(merged_world_id, &body_def);
+        for (const TileRect &rect : rects)
+        {
+            add_box(body_id, rect);
+        }
+        report("merged", merged_world_id, merge_ms + merged_timer.elapsed_ms());
+    }
+
+    return true;
+}
+
+// Mirrors the game's `Collider` listeners, so both spawn paths pay for what they would in game.
+struct BenchColliderListener
+{
+    Physics *physics;
+
+    void on_construct(entt::registry &registry, entt::entity entity)
+    {
+        auto &collider = registry.get<Collider>(entity);
+        if (!collider.id)
+        {
+            physics->add(entity, registry.get<const Transform>(entity), collider);
+        }
+    }
+
+    void on_destroy(entt::registry &registry, entt::entity entity)
+    {
+        auto &collider = registry.get<Collider>(entity);
+        if (collider.id)
+        {
+            physics->remove(collider);
+        }
+    }
+};
+
+// Spawns `count` coins with a sprite and a sensor collider one entity and component at a time,
+// as the game used to, and in bulk from a prefab, each into a fresh registry and physics world,
+// and checks that both made every coin with all its components and a body.
+static bool bench_prefab_spawn(size_t count)
+{
+    const Prefab coin{
+        .sprite = Sprite{.texture_id = TextureId{}, .size = glm::ivec2(16, 16)},
+        .collider =
+            Collider{
+                .type = Collider::Type::statik,
+                .shape = Collider::Shape::circle(8.0f),
+                .overlap_only = true,
+            },
+        .components = {prefab_component<Coin>()},
+    };
+
+    std::vector<glm::vec2> positions;
+    size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    for (size_t i = 0; i < count; ++i)
+    {
+        positions.emplace_back(
+            static_cast<float>(i % columns) * 32.0f,
+            static_cast<float>(i / columns) * 32.0f
+        );
+    }
+
+    auto run = [&](std::string_view method, auto &&spawn) {
+        Physics physics;
+        entt::registry registry;
+        BenchColliderListener listener{.physics = &physics};
+        registry.on_construct<Collider>().connect<&BenchColliderListener::on_construct>(listener);
+
+        BenchTimer timer;
+        spawn(registry, physics);
+        double elapsed_ms = timer.elapsed_ms();
+
+        // only coins that got every component and a body of their own count
+        size_t complete = 0;
+        auto coins = registry.view<const Transform, const Sprite, const Coin, const Collider>();
+        for (const auto [entity, transform, sprite, collider] : coins.each())
+        {
+            complete += collider.id.has_value();
+        }
+        spdlog::info(
+            "bench prefab_spawn: {:<10} {} entities: {:.3f}ms, {:.1f}ns per entity, {} complete "
+            "coins, {} bodies",
+            method,
+            count,
+            elapsed_ms,
+            elapsed_ms * 1e6 / static_cast<double>(count),
+            complete,
+            physics.get_body_count()
+        );
+        if (complete != count || registry.storage<Coin>().size() != count ||
+            physics.get_body_count() != count)
+        {
+            spdlog::error("bench prefab_spawn: {} did not spawn {} complete coins", method, count);
+            return false;
+        }
+        return true;
+    };
+
+    bool correct = run("per-entity", [&](entt::registry &registry, Physics &) {
+        for (const glm::vec2 &position : positions)
+        {
+            auto entity = registry.create();
+            registry.emplace<Coin>(entity);
+            registry.emplace<Transform>(entity, position);
+            registry.emplace<Sprite>(entity, *coin.sprite);
+            registry.emplace<Collider>(entity, *coin.collider);
+        }
+    });
+
+    correct = run("prefab", [&](entt::registry &registry, Physics &physics) {
+        PrefabSpawner spawner(&physics);
+        std::vector<entt::entity> entities(count);
+        spawner.spawn(registry, coin, positions, entities);
+    }) && correct;
+
+    return correct;
+}
+
+// Checks that `parallel_for` hands out non-empty ranges that cover every item exactly once.
+static bool check_job_ranges(JobSystem &jobs)
+{
+    std::mutex mutex;
+    std::vector<std::pair<int32_t, int32_t>> ranges;
+    for (int32_t min_range : {1, 3, 16})
+    {
+        for (int32_t count = 1; count <= 256; ++count)
+        {
+            ranges.clear();
+            jobs.parallel_for(count, min_range, [&](int32_t start, int32_t end, uint32_t) {
+                std::lock_guard lock(mutex);
+                ranges.emplace_back(start, end);
+            });
+
+            std::sort(ranges.begin(), ranges.end());
+            int32_t next = 0;
+            for (const auto &[start, end] : ranges)
+            {
+                if (start != next || end <= start)
+                {
+                    spdlog::error(
+                        "bench physics_step: {} workers split {} items into a range [{},{}) after "
+                        "item {}",
+                        jobs.get_worker_count(),
+                        count,
+                        start,
+                        end,
+                        next
+                    );
+                    return false;
+                }
+                next = end;
+            }
+            if (next != count)
+            {
+                spdlog::error(
+                    "bench physics_step: {} workers covered {} of {} items",
+                    jobs.get_worker_count(),
+                    next,
+                    count
+                );
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Steps a world of `body_count` boxes falling into a pile on 1, 2, 4, ... workers up to one per
+// hardware thread, and reports the time per step and how busy each worker was.
+static bool bench_physics_step(size_t body_count)
+{
+    constexpr int STEPS = 300;
+    constexpr float BOX_SIZE = 16.0f;
+    const Collider box{
+        .type = Collider::Type::dynamic,
+        .shape = Collider::Shape::rectangle(glm::vec2(BOX_SIZE)),
+    };
+
+    size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(body_count))));
+    std::vector<glm::vec2> positions;
+    std::vector<entt::entity> entities;
+    for (size_t i = 0; i < body_count; ++i)
+    {
+        positions.emplace_back(
+            static_cast<float>(i % columns) * (BOX_SIZE + 1.0f),
+            BOX_SIZE + static_cast<float>(i / columns) * (BOX_SIZE + 1.0f)
+        );
+        entities.push_back(static_cast<entt::entity>(i));
+    }
+    float width = static_cast<float>(columns) * (BOX_SIZE + 1.0f);
+    const PhysicsBox ground{
+        .center = glm::vec2(width / 2.0f, 0.0f),
+        .size = glm::vec2(width, 1.0f),
+    };
+
+    for (uint32_t worker_count : {1u, 2u, 3u, 8u})
+    {
+        JobSystem jobs(worker_count);
+        if (!check_job_ranges(jobs))
+        {
+            return false;
+        }
+    }
+
+    uint32_t max_workers = std::min(std::max(std::thread::hardware_concurrency(), 1u), 64u);
+    double single_worker_ms = 0.0;
+    for (uint32_t worker_count = 1;; worker_count = std::min(worker_count * 2, max_workers))
+    {
+        JobSystem jobs(worker_count);
+        Physics physics(&jobs);
+        physics.add_static_boxes({&ground, 1});
+        std::vector<PhysicsBodyId> body_ids(body_count);
+        physics.add_bodies(entities, positions, box, body_ids);
+
+        jobs.reset_stats();
+        BenchTimer timer;
+        for (int step = 0; step < STEPS; ++step)
+        {
+            physics.update(1.0 / 120.0);
+        }
+        double elapsed_ms = timer.elapsed_ms();
+        if (worker_count == 1)
+        {
+            single_worker_ms = elapsed_ms;
+        }
+
+        uint64_t min_busy_ns = UINT64_MAX;
+        uint64_t max_busy_ns = 0;
+        uint64_t steals = 0;
+        for (uint32_t worker = 0; worker < worker_count; ++worker)
+        {
+            JobWorkerStats stats = jobs.get_worker_stats(worker);
+            min_busy_ns = std::min(min_busy_ns, stats.busy_ns);
+            max_busy_ns = std::max(max_busy_ns, stats.busy_ns);
+            steals += stats.steal_count;
+        }
+        spdlog::info(
+            "bench physics_step: {} bodies, {:>2} workers: {:.3f}ms per step, {:.2f}x, workers "
+            "busy {:.1f}-{:.1f}%, {} jobs stolen",
+            body_count,
+            worker_count,
+            elapsed_ms / STEPS,
+            single_worker_ms / elapsed_ms,
+            static_cast<double>(min_busy_ns) / 1e4 / elapsed_ms,
+            static_cast<double>(max_busy_ns) / 1e4 / elapsed_ms,
+            steals
+        );
+
+        if (worker_count == max_workers)
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// Clock that only moves when asked to, oversleeping by a fixed amount.
+class BenchFrameClock final : public FrameClock
+{
+    uint64_t m_now_ns{0};
+    uint64_t m_oversleep_ns;
+
+  public:
+    explicit BenchFrameClock(uint64_t oversleep_ns) : m_oversleep_ns(oversleep_ns)
+    {
+    }
+
+    [[nodiscard]] uint64_t now_ns() override
+    {
+        // every reading takes a little time, so spinning makes progress
+        m_now_ns += 100;
+        return m_now_ns;
+    }
+
+    void sleep_ns(uint64_t duration_ns) override
+    {
+        m_now_ns += duration_ns + m_oversleep_ns;
+    }
+
+    void work(uint64_t duration_ns)
+    {
+        m_now_ns += duration_ns;
+    }
+};
+
+// Paces `frame_count` frames at 144 frames/s against a fake clock that oversleeps by 0.5ms, with
+// every 50th frame taking longer than a frame, and checks the rate and the missed deadlines. Then
+// paces up to 240 frames at 240 frames/s against the real clock and reports the jitter.
+static bool bench_frame_pacer(size_t frame_count)
+{
+    constexpr double TARGET_RATE = 144.0;
+    BenchFrameClock clock(500'000);
+    FramePacer pacer(&clock, TARGET_RATE);
+    uint64_t period_ns = pacer.get_period_ns();
+
+    uint64_t start_ns = clock.now_ns();
+    size_t expected_missed = 0;
+    size_t missed = 0;
+    for (size_t frame = 0; frame < frame_count; ++frame)
+    {
+        bool slow = frame % 50 == 49;
+        clock.work(slow ? period_ns * 3 / 2 : period_ns / 4 + (frame % 7) * 100'000);
+        expected_missed += slow;
+        missed += pacer.wait();
+    }
+    double rate = static_cast<double>(frame_count) * 1e9 /
+                  static_cast<double>(clock.now_ns() - start_ns);
+
+    // each slow frame delays the schedule by half a frame
+    double expected_rate = static_cast<double>(frame_count) * 1e9 /
+                           (static_cast<double>(frame_count) * static_cast<double>(period_ns) +
+                            static_cast<double>(expected_missed * period_ns / 2));
+    spdlog::info(
+        "bench frame_pacer: fake clock, {} frames at {:.2f} frames/s (expected {:.2f}), {} of {} "
+        "deadlines missed",
+        frame_count,
+        rate,
+        expected_rate,
+        missed,
+        expected_missed
+    );
+    if (missed != expected_missed || std::abs(rate - expected_rate) > 0.01 * rate)
+    {
+        spdlog::error("bench frame_pacer: pacing against the fake clock is off");
+        return false;
+    }
+
+    SDLFrameClock real_clock;
+    FramePacer real_pacer(&real_clock, 240.0);
+    size_t real_frames = std::min<size_t>(frame_count, 240);
+    BenchTimer timer;
+    for (size_t frame = 0; frame < real_frames; ++frame)
+    {
+        real_pacer.wait();
+    }
+    double elapsed_ms = timer.elapsed_ms();
+
+    const FramePacerStats &real = real_pacer.get_stats();
+    uint64_t paced = std::max<uint64_t>(real.frame_count - real.missed_count, 1);
+    spdlog::info(
+        "bench frame_pacer: real clock, {} frames at {:.2f} frames/s, jitter {:.3f}ms average, "
+        "{:.3f}ms max, {} missed, {:.1f}% spinning",
+        real.frame_count,
+        static_cast<double>(real_frames) * 1000.0 / elapsed_ms,
+        static_cast<double>(real.total_jitter_ns) / 1e6 / static_cast<double>(paced),
+        static_cast<double>(real.max_jitter_ns) / 1e6,
+        real.missed_count,
+        static_cast<double>(real.total_spin_ns) / 1e4 / elapsed_ms
+    );
+
+    return true;
+}
+
+// Pushes a burst of mouse motion and a tap of the space key, pressed and released again, into
+// SDL's event queue every frame of `frame_count` 1ms frames. Handles at most one event per frame
+// as the engine used to, then drains the queue every frame, and reports how many taps
+// `was_just_pressed` saw and how long their events waited in the queue.
+static bool bench_input_events(size_t frame_count)
+{
+    constexpr int MOTION_EVENTS_PER_FRAME = 16;
+    if (!SDL_InitSubSystem(SDL_INIT_EVENTS))
+    {
+        spdlog::error("bench input_events: failed to initialize sdl events: {}", SDL_GetError());
+        return false;
+    }
+
+    auto push_key = [](SDL_EventType type) {
+        SDL_Event event{};
+        event.key.type = type;
+        event.key.scancode = SDL_SCANCODE_SPACE;
+        event.key.down = type == SDL_EVENT_KEY_DOWN;
+        return SDL_PushEvent(&event);
+    };
+
+    bool complete = true;
+    for (bool drain : {false, true})
+    {
+        SDL_FlushEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST);
+        Input input;
+        size_t taps_seen = 0;
+        uint64_t total_latency_ns = 0;
+        uint64_t max_latency_ns = 0;
+        size_t transitions = 0;
+
+        for (size_t frame = 0; frame < frame_count; ++frame)
+        {
+            for (int i = 0; i < MOTION_EVENTS_PER_FRAME; ++i)
+            {
+                SDL_Event event{};
+                event.motion.type = SDL_EVENT_MOUSE_MOTION;
+                event.motion.x = static_cast<float>(i);
+                SDL_PushEvent(&event);
+            }
+            push_key(SDL_EVENT_KEY_DOWN);
+            push_key(SDL_EVENT_KEY_UP);
+
+            SDL_Event event;
+            while (SDL_PollEvent(&event))
+            {
+                input.handle_event(event);
+                if (!drain)
+                {
+                    break;
+                }
+            }
+
+            uint64_t now = SDL_GetTicksNS();
+            taps_seen += input.was_just_pressed(SDL_SCANCODE_SPACE);
+            for (const auto &transition : input.get_transitions())
+            {
+                total_latency_ns += now - transition.timestamp_ns;
+                max_latency_ns = std::max(max_latency_ns, now - transition.timestamp_ns);
+                ++transitions;
+            }
+            input.post_update();
+            SDL_DelayNS(1'000'000);
+        }
+
+        spdlog::info(
+            "bench input_events: {:<13} {} frames, {} of {} taps seen, latency {:.3f}ms average, "
+            "{:.3f}ms max, {} events still queued",
+            drain ? "drained" : "one per frame",
+            frame_count,
+            taps_seen,
+            frame_count,
+            transitions > 0
+                ? static_cast<double>(total_latency_ns) / 1e6 / static_cast<double>(transitions)
+                : 0.0,
+            static_cast<double>(max_latency_ns) / 1e6,
+            SDL_PeepEvents(nullptr, 0, SDL_PEEKEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST)
+        );
+        if (drain && taps_seen != frame_count)
+        {
+            spdlog::error("bench input_events: taps were lost while draining the queue");
+            complete = false;
+        }
+    }
+
+    SDL_FlushEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST);
+    SDL_QuitSubSystem(SDL_INIT_EVENTS);
+    return complete;
+}
+
+// Checks that destroying an entity twice removes its body once, that components recorded for an
+// entity destroyed in the same flush are dropped with it, and that pending entities get theirs.
+static bool check_command_buffers(JobSystem &jobs)
+{
+    Physics physics;
+    entt::registry registry;
+    BenchColliderListener listener{.physics = &physics};
+    registry.on_construct<Collider>().connect<&BenchColliderListener::on_construct>(listener);
+    registry.on_destroy<Collider>().connect<&BenchColliderListener::on_destroy>(listener);
+
+    const Collider collider{
+        .type = Collider::Type::statik,
+        .shape = Collider::Shape::circle(8.0f),
+        .overlap_only = true,
+    };
+    entt::entity twice = registry.create();
+    registry.emplace<Transform>(twice, glm::vec2(0.0f, 0.0f));
+    registry.emplace<Collider>(twice, collider);
+    entt::entity emplaced = registry.create();
+    registry.emplace<Transform>(emplaced, glm::vec2(32.0f, 0.0f));
+    registry.emplace<Collider>(emplaced, collider);
+    entt::entity kept = registry.create();
+    registry.emplace<Transform>(kept, glm::vec2(64.0f, 0.0f));
+    registry.emplace<Collider>(kept, collider);
+
+    CommandBuffers commands(&jobs);
+    CommandBuffer &local = commands.local();
+    local.destroy(twice);
+    local.destroy(twice);
+    local.emplace<Coin>(emplaced);
+    local.destroy(emplaced);
+    PendingEntity pending = local.create();
+    local.emplace<Transform>(pending, glm::vec2(96.0f, 0.0f));
+    local.emplace<Coin>(pending);
+    commands.flush(registry, physics);
+
+    if (registry.valid(twice) || registry.valid(emplaced) || !registry.valid(kept) ||
+        physics.get_body_count() != 1 || registry.storage<Collider>().size() != 1)
+    {
+        spdlog::error("bench command_buffer: destroyed the wrong entities or bodies");
+        return false;
+    }
+
+    auto coins = registry.view<const Coin, const Transform>();
+    if (registry.storage<Coin>().size() != 1 || coins.begin() == coins.end() ||
+        coins.get<const Transform>(*coins.begin()).position != glm::vec2(96.0f, 0.0f))
+    {
+        spdlog::error("bench command_buffer: the pending entity did not get its components");
+        return false;
+    }
+
+    // destroying an entity that is already gone by the flush is harmless too
+    local.destroy(twice);
+    commands.flush(registry, physics);
+    if (!registry.valid(kept) || physics.get_body_count() != 1)
+    {
+        spdlog::error("bench command_buffer: destroying a destroyed entity had an effect");
+        return false;
+    }
+    return true;
+}
+
+// Checks `CommandBuffers`, then picks up `count` coins like the game does, destroying each coin
+// and creating an entity with a component in its place, one at a time and through
+// `CommandBuffers`, and checks that no coin or body is left.
+static bool bench_command_buffer(size_t count)
+{
+    const Prefab coin{
+        .sprite = Sprite{.texture_id = TextureId{}, .size = glm::ivec2(16, 16)},
+        .collider =
+            Collider{
+                .type = Collider::Type::statik,
+                .shape = Collider::Shape::circle(8.0f),
+                .overlap_only = true,
+            },
+        .components = {prefab_component<Coin>()},
+    };
+
+    std::vector<glm::vec2> positions;
+    size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    for (size_t i = 0; i < count; ++i)
+    {
+        positions.emplace_back(
+            static_cast<float>(i % columns) * 32.0f,
+            static_cast<float>(i / columns) * 32.0f
+        );
+    }
+
+    JobSystem jobs(1);
+    auto run = [&](std::string_view method, auto &&pick_up) {
+        Physics physics;
+        entt::registry registry;
+        BenchColliderListener listener{.physics = &physics};
+        registry.on_construct<Collider>().connect<&BenchColliderListener::on_construct>(listener);
+        registry.on_destroy<Collider>().connect<&BenchColliderListener::on_destroy>(listener);
+
+        PrefabSpawner spawner(&physics);
+        std::vector<entt::entity> entities(count);
+        spawner.spawn(registry, coin, positions, entities);
+
+        BenchTimer timer;
+        pick_up(registry, physics);
+        double elapsed_ms = timer.elapsed_ms();
+
+        spdlog::info(
+            "bench command_buffer: {:<10} {} coins: {:.3f}ms, {:.1f}ns per coin, {} coins and {} "
+            "transforms left",
+            method,
+            count,
+            elapsed_ms,
+            elapsed_ms * 1e6 / static_cast<double>(count),
+            registry.storage<Coin>().size(),
+            registry.storage<Transform>().size()
+        );
+        if (registry.storage<Coin>().size() != 0 || registry.storage<Transform>().size() != count ||
+            physics.get_body_count() != 0)
+        {
+            spdlog::error(
+                "bench command_buffer: {} left coins, their bodies or too few transforms",
+                method
+            );
+            return false;
+        }
+        return true;
+    };
+
+    if (!check_command_buffers(jobs))
+    {
+        return false;
+    }
+
+    bool correct = run("immediate", [&](entt::registry &registry, Physics &) {
+        // the view can not be iterated while it changes, so go over a copy of its entities
+        auto coins = registry.view<const Coin>();
+        std::vector<entt::entity> picked_up(coins.begin(), coins.end());
+        for (auto entity : picked_up)
+        {
+            glm::vec2 position = registry.get<const Transform>(entity).position;
+            registry.destroy(entity);
+            registry.emplace<Transform>(registry.create(), position);
+        }
+    });
+
+    correct = run("buffered", [&](entt::registry &registry, Physics &physics) {
+        CommandBuffers commands(&jobs);
+        CommandBuffer &local = commands.local();
+        for (const auto [entity, transform] : registry.view<const Coin, const Transform>().each())
+        {
+            local.destroy(entity);
+            local.emplace<Transform>(local.create(), transform.position);
+        }
+        commands.flush(registry, physics);
+    }) && correct;
+
+    return correct;
+}
+
+template<size_t N>
+struct BenchComponent
+{
+    float value;
+};
+
+// Updates one of 8 written components from two of 8 read-only ones, so systems only conflict with
+// those writing the same component.
+template<size_t W>
+static void run_bench_system(entt::registry &registry, JobSystem *chunk_jobs)
+{
+    auto view = registry.view<
+        BenchComponent<W>,
+        const BenchComponent<8 + W>,
+        const BenchComponent<8 + (W + 3) % 8>>();
+    auto update = [&](entt::entity entity) {
+        auto [written, a, b] = view.get(entity);
+        written.value = written.value * 0.5f + std::sqrt(a.value * b.value + 1.0f);
+    };
+
+    if (chunk_jobs != nullptr)
+    {
+        parallel_each(*chunk_jobs, view, 1024, update);
+    }
+    else
+    {
+        for (auto entity : view)
+        {
+            update(entity);
+        }
+    }
+}
+
+template<size_t W>
+static void add_bench_system(SystemGraph &graph, entt::registry &registry, JobSystem *chunk_jobs)
+{
+    auto run = [&registry, chunk_jobs] { run_bench_system<W>(registry, chunk_jobs); };
+    graph.add("bench_system", run)
+        .writes<BenchComponent<W>>()
+        .reads<BenchComponent<8 + W>, BenchComponent<8 + (W + 3) % 8>>();
+}
+
+template<size_t... Ns>
+static void emplace_bench_components(entt::registry &registry, std::index_sequence<Ns...>)
+{
+    for (auto entity : registry.view<entt::entity>())
+    {
+        (registry.emplace_or_replace<BenchComponent<Ns>>(entity, static_cast<float>(Ns)), ...);
+    }
+}
+
+template<size_t... Ns>
+static double sum_bench_components(entt::registry &registry, std::index_sequence<Ns...>)
+{
+    double sum = 0.0;
+    for (auto entity : registry.view<entt::entity>())
+    {
+        sum += (static_cast<double>(registry.get<const BenchComponent<Ns>>(entity).value) + ...);
+    }
+    return sum;
+}
+
+// Runs `system_count` systems over 10000 entities with 16 components one after the other, then
+// scheduled by a `SystemGraph` on all hardware threads, and then also splitting each system's
+// view into chunks, checking that all three compute the same values.
+static bool bench_system_graph(size_t system_count)
+{
+    constexpr size_t ENTITY_COUNT = 10'000;
+    constexpr int FRAMES = 20;
+
+    entt::registry registry;
+    for (size_t i = 0; i < ENTITY_COUNT; ++i)
+    {
+        static_cast<void>(registry.create());
+    }
+
+    const std::array run_systems{
+        run_bench_system<0>,
+        run_bench_system<1>,
+        run_bench_system<2>,
+        run_bench_system<3>,
+        run_bench_system<4>,
+        run_bench_system<5>,
+        run_bench_system<6>,
+        run_bench_system<7>,
+    };
+    const std::array add_systems{
+        add_bench_system<0>,
+        add_bench_system<1>,
+        add_bench_system<2>,
+        add_bench_system<3>,
+        add_bench_system<4>,
+        add_bench_system<5>,
+        add_bench_system<6>,
+        add_bench_system<7>,
+    };
+
+    // sums the written components, which every method must leave with exactly the same values
+    auto report = [&](std::string_view method, double elapsed_ms, size_t waves) {
+        double checksum = sum_bench_components(registry, std::make_index_sequence<8>());
+        spdlog::info(
+            "bench system_graph: {} systems, {:<10} {:.3f}ms per frame, {} waves, checksum {}",
+            system_count,
+            method,
+            elapsed_ms / FRAMES,
+            waves,
+            checksum
+        );
+        return checksum;
+    };
+
+    emplace_bench_components(registry, std::make_index_sequence<16>());
+    BenchTimer sequential_timer;
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        for (size_t i = 0; i < system_count; ++i)
+        {
+            run_systems[i % run_systems.size()](registry, nullptr);
+        }
+    }
+    double sequential_checksum = report("sequential", sequential_timer.elapsed_ms(), system_count);
+
+    JobSystem jobs;
+    for (bool chunked : {false, true})
+    {
+        SystemGraph graph(&jobs);
+        for (size_t i = 0; i < system_count; ++i)
+        {
+            add_systems[i % add_systems.size()](graph, registry, chunked ? &jobs : nullptr);
+        }
+        graph.build(registry);
+
+        emplace_bench_components(registry, std::make_index_sequence<16>());
+        BenchTimer timer;
+        for (int frame = 0; frame < FRAMES; ++frame)
+        {
+            graph.run();
+        }
+        std::string_view method = chunked ? "chunked" : "graph";
+        if (report(method, timer.elapsed_ms(), graph.get_wave_count()) != sequential_checksum)
+        {
+            spdlog::error("bench system_graph: {} checksum differs from sequential", method);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+struct Benchmark
+{
+    std::string_view name;
+    size_t default_size;
+    std::function<bool(size_t)> run;
+};
+
+bool run_benchmark(std::string_view name, size_t size)
+{
+    static const Benchmark benchmarks[] = {
+        {"coin_contacts", 10'000, bench_coin_contacts},
+        {"sprite_culling", 1'000'000, bench_sprite_culling},
+        {"asset_decode", 256, bench_asset_decode},
+        {"atlas_pack", 4096, bench_atlas_pack},
+        {"upload_ring", 1'000'000, bench_upload_ring},
+        {"audio_mix", 60, bench_audio_mix},
+        {"audio_commands", 100'000, bench_audio_commands},
+        {"audio_stream", 600, bench_audio_stream},
+        {"slot_map", 1'000'000, bench_slot_map},
+        {"level_parse", 4096, bench_level_parse},
+        {"tile_merge", 256, bench_tile_merge},
+        {"prefab_spawn", 100'000, bench_prefab_spawn},
+        {"physics_step", 4'000, bench_physics_step},
+        {"system_graph", 256, bench_system_graph},
+        {"command_buffer", 100'000, bench_command_buffer},
+        {"frame_pacer", 10'000, bench_frame_pacer},
+        {"input_events", 600, bench_input_events},
+    };
+
+    for (const auto &benchmark : benchmarks)
+    {
+        if (benchmark.name == name)
+        {
+            return benchmark.run(size == 0 ? benchmark.default_size : size);
+        }
+    }
+
+    spdlog::error("run_benchmark: unknown benchmark `{}`", name);
+    return false;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <string_view>
+
+// Runs the named micro benchmark and logs its results, returns false if there is no benchmark
+// with that name or one of its checks failed. `size` scales the workload, 0 selects the
+// benchmark's default.
+[[nodiscard]] bool run_benchmark(std::string_view name, size_t size);
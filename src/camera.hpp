@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/glm.hpp>
+
+#include "aabb.hpp"
+
+// Orthographic 2D camera, `position` is the world position of the bottom-left corner of the view.
+struct Camera
+{
+    glm::vec2 position{0.0f};
+    glm::vec2 size{0.0f};
+
+    [[nodiscard]] glm::mat4 get_projection() const
+    {
+        return glm::ortho(position.x, position.x + size.x, position.y, position.y + size.y);
+    }
+
+    [[nodiscard]] Aabb get_bounds() const
+    {
+        return Aabb{.min = position, .max = position + size};
+    }
+};
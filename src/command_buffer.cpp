@@ -0,0 +1,57 @@
+#include "command_buffer.hpp"
+
+#include <algorithm>
+
+#include "ecs.hpp"
+#include "profiler.hpp"
+
+void CommandBuffer::flush_creates(entt::registry &registry)
+{
+    m_created.resize(m_pending_count);
+    registry.create(m_created.begin(), m_created.end());
+    m_pending_count = 0;
+
+    for (auto &[type, pool] : m_pools)
+    {
+        pool->flush(registry, m_created);
+    }
+    m_created.clear();
+}
+
+void CommandBuffers::flush(entt::registry &registry, Physics &physics)
+{
+    PROFILE_ZONE("CommandBuffers::flush");
+    m_destroyed.clear();
+    for (auto &buffer : m_buffers)
+    {
+        buffer.flush_creates(registry);
+        m_destroyed.insert(m_destroyed.end(), buffer.m_destroyed.begin(), buffer.m_destroyed.end());
+        buffer.m_destroyed.clear();
+    }
+    if (m_destroyed.empty())
+    {
+        return;
+    }
+
+    std::sort(m_destroyed.begin(), m_destroyed.end());
+    m_destroyed.erase(std::unique(m_destroyed.begin(), m_destroyed.end()), m_destroyed.end());
+    std::erase_if(m_destroyed, [&](entt::entity entity) { return !registry.valid(entity); });
+
+    m_removed_bodies.clear();
+    auto colliders = registry.view<Collider>();
+    for (auto entity : m_destroyed)
+    {
+        if (colliders.contains(entity))
+        {
+            auto &collider = colliders.get<Collider>(entity);
+            if (collider.id)
+            {
+                m_removed_bodies.push_back(*collider.id);
+                collider.id.reset();
+            }
+        }
+    }
+    physics.remove_bodies(m_removed_bodies);
+
+    registry.destroy(m_destroyed.begin(), m_destroyed.end());
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "job_system.hpp"
+#include "physics.hpp"
+
+// Entity created by a `CommandBuffer`, which only exists once the buffer has been flushed.
+struct PendingEntity
+{
+    uint32_t index;
+};
+
+// Records structural changes to a registry so they can be made while iterating views, or from
+// several threads, and applied in bulk later. Components are inserted with one range `insert` per
+// type and buffer, so listeners still run, but entities are created and destroyed in batches.
+class CommandBuffer
+{
+    friend class CommandBuffers;
+
+    struct ComponentPool
+    {
+        virtual ~ComponentPool() = default;
+        virtual void flush(entt::registry &registry, std::span<const entt::entity> created) = 0;
+    };
+
+    template<typename T>
+    struct TypedComponentPool final : ComponentPool
+    {
+        static constexpr uint32_t NOT_PENDING = UINT32_MAX;
+
+        std::vector<entt::entity> targets;
+        // index of the pending entity that replaces `targets[i]`, or `NOT_PENDING`
+        std::vector<uint32_t> pending;
+        std::vector<T> values;
+
+        void flush(entt::registry &registry, std::span<const entt::entity> created) override;
+    };
+
+    uint32_t m_pending_count{0};
+    std::vector<entt::entity> m_created;
+    std::vector<entt::entity> m_destroyed;
+    // in the order the component types were first used, so flushes are deterministic
+    std::vector<std::pair<entt::id_type, std::unique_ptr<ComponentPool>>> m_pools;
+
+  public:
+    [[nodiscard]] PendingEntity create()
+    {
+        return PendingEntity{m_pending_count++};
+    }
+
+    // destroying an entity twice, or one that is gone by the time of the flush, is harmless
+    void destroy(entt::entity entity)
+    {
+        m_destroyed.push_back(entity);
+    }
+
+    // the entity must not have a `T` yet when the buffer is flushed, or be gone by then
+    template<typename T, typename... Args>
+    void emplace(entt::entity entity, Args &&...args)
+    {
+        auto &pool = get_pool<T>();
+        pool.targets.push_back(entity);
+        pool.pending.push_back(TypedComponentPool<T>::NOT_PENDING);
+        pool.values.push_back(T{std::forward<Args>(args)...});
+    }
+
+    template<typename T, typename... Args>
+    void emplace(PendingEntity entity, Args &&...args)
+    {
+        auto &pool = get_pool<T>();
+        pool.targets.push_back(entt::null);
+        pool.pending.push_back(entity.index);
+        pool.values.push_back(T{std::forward<Args>(args)...});
+    }
+
+  private:
+    template<typename T>
+    [[nodiscard]] TypedComponentPool<T> &get_pool();
+
+    // creates the pending entities and adds the recorded components
+    void flush_creates(entt::registry &registry);
+};
+
+// One `CommandBuffer` per job system worker, so systems running in parallel never share one.
+class CommandBuffers
+{
+    JobSystem *m_jobs;
+    std::vector<CommandBuffer> m_buffers;
+    std::vector<entt::entity> m_destroyed;
+    std::vector<PhysicsBodyId> m_removed_bodies;
+
+  public:
+    explicit CommandBuffers(JobSystem *jobs) : m_jobs(jobs), m_buffers(jobs->get_worker_count())
+    {
+    }
+
+    // the buffer of the worker running the calling thread
+    [[nodiscard]] CommandBuffer &local()
+    {
+        return m_buffers[m_jobs->get_current_worker()];
+    }
+
+    // Applies every recorded change: creations and components first, then destructions. The
+    // bodies of destroyed colliders are removed from `physics` in a single batch beforehand, so
+    // `Collider` listeners must leave colliders without a body alone.
+    void flush(entt::registry &registry, Physics &physics);
+};
+
+template<typename T>
+void CommandBuffer::TypedComponentPool<T>::flush(
+    entt::registry &registry, std::span<const entt::entity> created
+)
+{
+    // drop components of entities destroyed since they were recorded
+    size_t count = 0;
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        entt::entity entity = pending[i] == NOT_PENDING ? targets[i] : created[pending[i]];
+        if (registry.valid(entity))
+        {
+            targets[count] = entity;
+            if (count != i)
+            {
+                values[count] = std::move(values[i]);
+            }
+            ++count;
+        }
+    }
+
+    registry.insert<T>(targets.begin(), targets.begin() + count, values.begin());
+    targets.clear();
+    pending.clear();
+    values.clear();
+}
+
+template<typename T>
+CommandBuffer::TypedComponentPool<T> &CommandBuffer::get_pool()
+{
+    entt::id_type type = entt::type_hash<T>::value();
+    for (auto &[pool_type, pool] : m_pools)
+    {
+        if (pool_type == type)
+        {
+            return static_cast<TypedComponentPool<T> &>(*pool);
+        }
+    }
+    m_pools.emplace_back(type, std::make_unique<TypedComponentPool<T>>());
+    return static_cast<TypedComponentPool<T> &>(*m_pools.back().second);
+}
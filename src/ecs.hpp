@@ -76,19 +76,28 @@ struct Collider
     Type type;
     Shape shape;
     glm::vec2 velocity{0.0f};
-    bool gravity{true};
+    // times the world gravity, 0 for bodies that only move when told to
+    float gravity_scale{1.0f};
     bool overlap_only{false};
 };
 
-struct Player
+// Body positions after the last two physics steps, used to smooth rendering between steps.
+struct PhysicsInterpolation
 {
+    glm::vec2 previous_position;
+    glm::vec2 current_position;
 };
 
-struct AudioPlayer
+struct Player
 {
-    AudioSourceId source;
 };
 
 struct Coin
 {
 };
+
+// Index into `Level::spawns` of the spawn an entity was created from.
+struct LevelSpawnRef
+{
+    uint32_t spawn;
+};
@@ -1,22 +1,78 @@
 #include "engine.hpp"
 
+#include <filesystem>
+
 #include <SDL3/SDL_gpu.h>
 
+#include "gpu_renderer.hpp"
+#include "null_audio.hpp"
+#include "null_renderer.hpp"
+#include "profiler.hpp"
+#include "sdl_audio.hpp"
+
 bool Engine::init()
 {
-    if (!m_systems.renderer.init(m_window))
+    if (std::filesystem::exists(ASSET_PACK_PATH))
     {
-        spdlog::error("Engine::init: failed to initialize renderer");
-        return false;
+        if (!m_systems.asset_pack.open(ASSET_PACK_PATH))
+        {
+            spdlog::warn("Engine::init: failed to open asset pack, loading assets from files");
+        }
+    }
+    else
+    {
+        spdlog::info("Engine::init: no asset pack found, loading assets from files");
     }
-    spdlog::info("Engine::init renderer initialized");
 
-    if (!m_systems.audio.init())
+    if (m_window == nullptr)
     {
-        spdlog::error("Engine::init: failed to initialize audio");
-        return false;
+        m_systems.renderer = std::make_unique<NullRenderer>();
+        m_systems.audio = std::make_unique<NullAudio>();
+        spdlog::info("Engine::init: running headless, using null renderer and audio");
+    }
+    else
+    {
+        auto renderer = std::make_unique<GPURenderer>();
+        if (!renderer->init(m_window, &m_systems.asset_pack))
+        {
+            spdlog::error("Engine::init: failed to initialize renderer");
+            return false;
+        }
+        m_systems.renderer = std::move(renderer);
+        spdlog::info("Engine::init renderer initialized");
+
+        if (!m_systems.renderer->set_present_mode(m_frame_settings.present_mode))
+        {
+            spdlog::warn("Engine::init: falling back to vsync");
+            m_frame_settings.present_mode = PresentMode::vsync;
+        }
+        if (!m_systems.renderer->set_frames_in_flight(m_frame_settings.frames_in_flight))
+        {
+            spdlog::error("Engine::init: failed to set frames in flight");
+            return false;
+        }
+        spdlog::info(
+            "Engine::init: presenting with {} and {} frames in flight",
+            get_present_mode_name(m_frame_settings.present_mode),
+            m_frame_settings.frames_in_flight
+        );
+        if (m_frame_settings.target_rate > 0.0)
+        {
+            spdlog::info(
+                "Engine::init: limiting the frame rate to {} frames/s",
+                m_frame_settings.target_rate
+            );
+        }
+
+        auto audio = std::make_unique<SDLAudio>();
+        if (!audio->init())
+        {
+            spdlog::error("Engine::init: failed to initialize audio");
+            return false;
+        }
+        m_systems.audio = std::move(audio);
+        spdlog::info("Engine::init audio initialized");
     }
-    spdlog::info("Engine::init audio initialized");
 
     if (!m_game.init())
     {
@@ -30,43 +86,110 @@ bool Engine::init()
 
 void Engine::render()
 {
-    m_systems.renderer.render(m_game.get_entities());
+    PROFILE_ZONE("Engine::render");
+    m_systems.renderer->render(m_game.get_entities());
 }
 
 void Engine::update()
 {
-    m_systems.physics.update(m_delta_time);
+    PROFILE_ZONE("Engine::update");
     m_game.update(m_delta_time);
 
+    int steps = m_physics_timestep.advance(m_delta_time);
+    for (int i = 0; i < steps; ++i)
+    {
+        m_systems.physics.update(m_physics_timestep.get_step());
+        m_game.post_physics_step();
+    }
+    if (m_physics_timestep.get_last_dropped_time() > 0.0)
+    {
+        spdlog::debug(
+            "Engine::update: physics fell behind, dropped {:.3f}s after {} steps",
+            m_physics_timestep.get_last_dropped_time(),
+            steps
+        );
+    }
+    m_game.interpolate_transforms(m_physics_timestep.get_alpha());
+
     m_systems.input.post_update();
 }
 
 void Engine::run()
 {
-    m_last_frame_time = SDL_GetTicks() / 1000.0;
+    m_last_frame_time_ns = SDL_GetTicksNS();
+    m_frame_pacer.set_target_rate(m_frame_settings.target_rate);
+    m_frame_pacer.reset_stats();
 
     spdlog::trace("Engine::run: entering main loop");
     while (true)
     {
-        double now = SDL_GetTicks() / 1000.0;
-        m_delta_time = now - m_last_frame_time;
-        m_last_frame_time = now;
+        uint64_t now_ns = SDL_GetTicksNS();
+        m_delta_time = static_cast<double>(now_ns - m_last_frame_time_ns) / 1e9;
+        m_last_frame_time_ns = now_ns;
 
+        // drain the whole queue, so events never wait a frame behind others
         SDL_Event event;
-        if (SDL_PollEvent(&event))
+        while (SDL_PollEvent(&event))
         {
             if (event.type == SDL_EVENT_QUIT)
             {
                 return;
             }
-            else if (event.type == SDL_EVENT_KEY_DOWN || event.type == SDL_EVENT_KEY_UP)
-            {
-                m_systems.input.handle_event(event.key);
-            }
+            m_systems.input.handle_event(event);
         }
 
         update();
         render();
+
+        Profiler::end_frame();
+        m_frame_pacer.wait();
     }
     spdlog::trace("Engine::run: exited main loop");
 }
+
+void Engine::run_headless(uint64_t frame_count, double delta_time)
+{
+    spdlog::info(
+        "Engine::run_headless: simulating {} frames with a delta time of {:.4f}s",
+        frame_count,
+        delta_time
+    );
+
+    uint64_t start_physics_steps = m_physics_timestep.get_total_steps();
+    m_systems.jobs.reset_stats();
+    uint64_t start = SDL_GetPerformanceCounter();
+
+    m_delta_time = delta_time;
+    for (uint64_t frame = 0; frame < frame_count; ++frame)
+    {
+        update();
+        render();
+
+        Profiler::end_frame();
+    }
+
+    double elapsed = static_cast<double>(SDL_GetPerformanceCounter() - start) /
+                     static_cast<double>(SDL_GetPerformanceFrequency());
+    uint64_t physics_steps = m_physics_timestep.get_total_steps() - start_physics_steps;
+    spdlog::info(
+        "Engine::run_headless: {} frames, {} physics steps in {:.3f}s ({:.1f} frames/s, {:.3f}ms "
+        "per frame)",
+        frame_count,
+        physics_steps,
+        elapsed,
+        static_cast<double>(frame_count) / elapsed,
+        elapsed * 1000.0 / static_cast<double>(frame_count)
+    );
+    for (uint32_t worker = 0; worker < m_systems.jobs.get_worker_count(); ++worker)
+    {
+        JobWorkerStats stats = m_systems.jobs.get_worker_stats(worker);
+        spdlog::info(
+            "Engine::run_headless: worker {}: {:.3f}ms busy ({:.1f}%), {} jobs, {} stolen",
+            worker,
+            static_cast<double>(stats.busy_ns) / 1e6,
+            static_cast<double>(stats.busy_ns) / 1e7 / elapsed,
+            stats.job_count,
+            stats.steal_count
+        );
+    }
+}
@@ -4,19 +4,39 @@
 #include <entt/entt.hpp>
 #include <spdlog/spdlog.h>
 
+#include "fixed_timestep.hpp"
+#include "frame_pacer.hpp"
 #include "game.hpp"
 #include "systems.hpp"
 
 constexpr int WIDTH = 1280;
 constexpr int HEIGHT = 736;
 
+struct FrameSettings
+{
+    PresentMode present_mode{PresentMode::vsync};
+    // frames per second `Engine::run` is limited to, 0 leaves pacing to the present mode
+    double target_rate{0.0};
+    uint32_t frames_in_flight{2};
+};
+
 class Engine
 {
+    static constexpr double PHYSICS_STEP = 1.0 / 120.0;
+    static constexpr int MAX_PHYSICS_STEPS_PER_FRAME = 8;
+    static constexpr const char *ASSET_PACK_PATH = "./assets.pack";
+
     SDL_Window *m_window;
+    FrameSettings m_frame_settings;
 
-    double m_last_frame_time{0.0};
+    uint64_t m_last_frame_time_ns{0};
     double m_delta_time{0.0};
 
+    SDLFrameClock m_frame_clock;
+    FramePacer m_frame_pacer;
+
+    FixedTimestep m_physics_timestep{PHYSICS_STEP, MAX_PHYSICS_STEPS_PER_FRAME};
+
     Systems m_systems;
     Game m_game;
 
@@ -27,7 +47,10 @@ class Engine
     Engine &operator=(Engine &&) = delete;
 
   public:
-    Engine(SDL_Window *window) : m_window(window), m_game(this)
+    // passing no window runs the engine headless with null renderer and audio backends
+    Engine(SDL_Window *window, const FrameSettings &frame_settings = {})
+        : m_window(window), m_frame_settings(frame_settings),
+          m_frame_pacer(&m_frame_clock, frame_settings.target_rate), m_game(this)
     {
     }
 
@@ -35,6 +58,8 @@ class Engine
 
     void run();
 
+    void run_headless(uint64_t frame_count, double delta_time);
+
     [[nodiscard]] Systems *get_systems()
     {
         return &m_systems;
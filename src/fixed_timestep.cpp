@@ -0,0 +1,23 @@
+#include "fixed_timestep.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+int FixedTimestep::advance(double delta_time)
+{
+    m_accumulator += std::max(delta_time, 0.0);
+
+    int steps = static_cast<int>(std::min(std::floor(m_accumulator / m_step), 1.0 * m_max_steps));
+    m_accumulator -= steps * m_step;
+    m_total_steps += steps;
+
+    m_last_dropped_time = 0.0;
+    if (m_accumulator >= m_step)
+    {
+        m_last_dropped_time = std::floor(m_accumulator / m_step) * m_step;
+        m_accumulator -= m_last_dropped_time;
+        m_total_dropped_time += m_last_dropped_time;
+    }
+
+    return steps;
+}
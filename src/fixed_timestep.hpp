@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+// Accumulates variable frame times and hands them out as a bounded number of fixed-size
+// steps. Time that cannot be caught up within `max_steps` is dropped instead of carried
+// over, so a single long frame cannot snowball into ever longer ones.
+class FixedTimestep
+{
+    double m_step;
+    int m_max_steps;
+    double m_accumulator{0.0};
+
+    uint64_t m_total_steps{0};
+    double m_last_dropped_time{0.0};
+    double m_total_dropped_time{0.0};
+
+  public:
+    FixedTimestep(double step, int max_steps) : m_step(step), m_max_steps(max_steps)
+    {
+    }
+
+    [[nodiscard]] int advance(double delta_time);
+
+    // how far the simulation has progressed from the last step towards the next one, in [0, 1)
+    [[nodiscard]] float get_alpha() const
+    {
+        return static_cast<float>(m_accumulator / m_step);
+    }
+
+    [[nodiscard]] double get_step() const
+    {
+        return m_step;
+    }
+
+    [[nodiscard]] int get_max_steps() const
+    {
+        return m_max_steps;
+    }
+
+    [[nodiscard]] uint64_t get_total_steps() const
+    {
+        return m_total_steps;
+    }
+
+    [[nodiscard]] double get_last_dropped_time() const
+    {
+        return m_last_dropped_time;
+    }
+
+    [[nodiscard]] double get_total_dropped_time() const
+    {
+        return m_total_dropped_time;
+    }
+};
@@ -0,0 +1,102 @@
+#include "frame_pacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <SDL3/SDL_timer.h>
+#include <spdlog/spdlog.h>
+
+uint64_t SDLFrameClock::now_ns()
+{
+    return SDL_GetTicksNS();
+}
+
+void SDLFrameClock::sleep_ns(uint64_t duration_ns)
+{
+    SDL_DelayNS(duration_ns);
+}
+
+FramePacer::FramePacer(FrameClock *clock, double target_rate, uint64_t spin_ns)
+    : m_clock(clock), m_spin_ns(spin_ns), m_stats_start_ns(clock->now_ns())
+{
+    set_target_rate(target_rate);
+}
+
+void FramePacer::set_target_rate(double target_rate)
+{
+    m_period_ns = target_rate > 0.0 ? static_cast<uint64_t>(std::llround(1e9 / target_rate)) : 0;
+    m_deadline_ns = m_clock->now_ns() + m_period_ns;
+}
+
+bool FramePacer::wait()
+{
+    uint64_t now = m_clock->now_ns();
+    ++m_stats.frame_count;
+
+    bool missed = false;
+    if (m_period_ns != 0)
+    {
+        if (now > m_deadline_ns)
+        {
+            missed = true;
+            ++m_stats.missed_count;
+            m_deadline_ns = now;
+        }
+        else
+        {
+            if (m_deadline_ns - now > m_spin_ns)
+            {
+                m_clock->sleep_ns(m_deadline_ns - now - m_spin_ns);
+                uint64_t woken = m_clock->now_ns();
+                m_stats.total_sleep_ns += woken - now;
+                now = woken;
+            }
+
+            uint64_t spin_start = now;
+            while (now < m_deadline_ns)
+            {
+                now = m_clock->now_ns();
+            }
+            m_stats.total_spin_ns += now - spin_start;
+
+            uint64_t jitter = now - m_deadline_ns;
+            m_stats.total_jitter_ns += jitter;
+            m_stats.max_jitter_ns = std::max(m_stats.max_jitter_ns, jitter);
+        }
+        m_deadline_ns += m_period_ns;
+    }
+
+    if (now - m_stats_start_ns >= STATS_INTERVAL_NS)
+    {
+        log_stats(now);
+        reset_stats();
+    }
+    return missed;
+}
+
+void FramePacer::reset_stats()
+{
+    m_stats = FramePacerStats{};
+    m_stats_start_ns = m_clock->now_ns();
+}
+
+void FramePacer::log_stats(uint64_t now_ns) const
+{
+    double elapsed = static_cast<double>(now_ns - m_stats_start_ns) / 1e9;
+    uint64_t paced_frames = m_stats.frame_count - m_stats.missed_count;
+    double average_jitter_ms =
+        paced_frames > 0
+            ? static_cast<double>(m_stats.total_jitter_ns) / 1e6 / static_cast<double>(paced_frames)
+            : 0.0;
+    spdlog::info(
+        "FramePacer::wait: {} frames at {:.1f} frames/s, jitter {:.3f}ms average, {:.3f}ms max, "
+        "{} missed deadlines, {:.1f}% sleeping, {:.1f}% spinning",
+        m_stats.frame_count,
+        static_cast<double>(m_stats.frame_count) / elapsed,
+        average_jitter_ms,
+        static_cast<double>(m_stats.max_jitter_ns) / 1e6,
+        m_stats.missed_count,
+        static_cast<double>(m_stats.total_sleep_ns) / 1e7 / elapsed,
+        static_cast<double>(m_stats.total_spin_ns) / 1e7 / elapsed
+    );
+}
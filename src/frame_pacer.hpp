@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+
+// Time source of a `FramePacer`, so pacing can be run against a fake clock.
+class FrameClock
+{
+  public:
+    virtual ~FrameClock() = default;
+
+    [[nodiscard]] virtual uint64_t now_ns() = 0;
+
+    // may return late, but never early
+    virtual void sleep_ns(uint64_t duration_ns) = 0;
+};
+
+class SDLFrameClock final : public FrameClock
+{
+  public:
+    [[nodiscard]] uint64_t now_ns() override;
+
+    void sleep_ns(uint64_t duration_ns) override;
+};
+
+struct FramePacerStats
+{
+    uint64_t frame_count{0};
+    // frames that were done after their deadline had passed
+    uint64_t missed_count{0};
+    // how long after their deadlines waits returned
+    uint64_t total_jitter_ns{0};
+    uint64_t max_jitter_ns{0};
+    uint64_t total_sleep_ns{0};
+    uint64_t total_spin_ns{0};
+};
+
+// Limits the frame rate by waiting at the end of each frame until the next one is due. Waits
+// sleep until shortly before the deadline, since sleeps tend to overshoot, and spin for the rest.
+// A frame that is done after its deadline is counted as missed and the schedule restarts from
+// then, instead of rushing the following frames to catch up.
+class FramePacer
+{
+  public:
+    static constexpr uint64_t DEFAULT_SPIN_NS = 1'000'000;
+    static constexpr uint64_t STATS_INTERVAL_NS = 5'000'000'000;
+
+  private:
+    FrameClock *m_clock;
+    // 0 leaves the frame rate unlimited
+    uint64_t m_period_ns{0};
+    uint64_t m_spin_ns;
+    uint64_t m_deadline_ns{0};
+
+    FramePacerStats m_stats;
+    uint64_t m_stats_start_ns;
+
+  public:
+    // a `target_rate` of 0 does not limit the frame rate
+    FramePacer(FrameClock *clock, double target_rate, uint64_t spin_ns = DEFAULT_SPIN_NS);
+
+    void set_target_rate(double target_rate);
+
+    // Called once at the end of every frame, returns whether the frame missed its deadline. Logs
+    // and resets the stats every `STATS_INTERVAL_NS`.
+    bool wait();
+
+    [[nodiscard]] const FramePacerStats &get_stats() const
+    {
+        return m_stats;
+    }
+
+    void reset_stats();
+
+    [[nodiscard]] uint64_t get_period_ns() const
+    {
+        return m_period_ns;
+    }
+
+  private:
+    void log_stats(uint64_t now_ns) const;
+};
@@ -1,144 +1,180 @@
 #include "game.hpp"
 
+#include <algorithm>
 #include <array>
+#include <string_view>
 
 #include <SDL3/SDL_scancode.h>
-#include <glm/ext/matrix_clip_space.hpp>
+#include <SDL3/SDL_timer.h>
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/fwd.hpp>
 #include <glm/gtx/norm.hpp>
 
+#include "asset_loader.hpp"
 #include "ecs.hpp"
 #include "engine.hpp"
+#include "profiler.hpp"
+#include "spatial_grid.hpp"
+#include "sprite_culling.hpp"
+#include "tilemap_collision.hpp"
 
-// clang-format off
-static std::array<char[41], 23> map{
-    "########################################",
-    "#                                      #",
-    "#                                      #",
-    "#                               C      #",
-    "#                              ##      #",
-    "#               C                      #",
-    "#             #########                #",
-    "#                                      #",
-    "#                                      #",
-    "#                                      #",
-    "#       C                 C  C         #",
-    "#     #####              ######        #",
-    "#                                      #",
-    "#                                      #",
-    "#               C                      #",
-    "#             ######                   #",
-    "#                                      #",
-    "#     C                  C             #",
-    "#    #####              #####          #",
-    "#                                      #",
-    "#                  P         C         #",
-    "#          C                           #",
-    "########################################",
-};
-// clang-format on
+// the cooked binary level is used from the asset pack when there is one
+static constexpr std::string_view LEVEL_PATH = "./assets/levels/level1.level";
+static constexpr std::string_view COOKED_LEVEL_PATH = "./assets/levels/level1.lvl";
 
-bool Game::init()
+Game::Game(Engine *engine)
+    : m_engine(engine), m_update_systems(&engine->get_systems()->jobs),
+      m_commands(&engine->get_systems()->jobs)
 {
-    m_engine->get_systems()->renderer.set_camera(glm::ortho(0.0f, 640.0f, 0.0f, 368.0f));
+}
 
-    auto jump_wav = m_engine->get_systems()->audio.new_source_from_wav("./assets/jump.wav");
-    auto pickup_join_wav =
-        m_engine->get_systems()->audio.new_source_from_wav("./assets/pickup_coin.wav");
+bool Game::init()
+{
+    uint64_t load_start_ns = SDL_GetTicksNS();
+    AssetLoader loader(
+        &m_engine->get_systems()->thread_pool,
+        &m_engine->get_systems()->asset_pack
+    );
+    std::array image_futures{
+        loader.load_image("./assets/knight.png"),
+        loader.load_image("./assets/block.png"),
+        loader.load_image("./assets/background.png"),
+        loader.load_image("./assets/coin.png"),
+    };
+    std::array wav_futures{
+        loader.load_wav("./assets/jump.wav"),
+        loader.load_wav("./assets/pickup_coin.wav"),
+    };
 
-    if (!jump_wav || !pickup_join_wav)
+    std::vector<ImageData> images;
+    for (auto &future : image_futures)
     {
-        spdlog::error("Game::init: failed to load wav files");
-        return false;
+        std::optional<ImageData> image = future.get();
+        if (!image)
+        {
+            spdlog::error("Game::init: failed to load image files");
+            return false;
+        }
+        images.push_back(std::move(*image));
     }
 
-    m_jump_wav = *jump_wav;
-    m_pickup_coin_wav = *pickup_join_wav;
-
-    size_t knight_texture_id, block_texture_id, bg_texture_id, coin_texture_id;
+    std::vector<TextureId> texture_ids;
     try
     {
-        knight_texture_id =
-            m_engine->get_systems()->renderer.new_texture_from_file("./assets/knight.png");
-        block_texture_id =
-            m_engine->get_systems()->renderer.new_texture_from_file("./assets/block.png");
-        bg_texture_id =
-            m_engine->get_systems()->renderer.new_texture_from_file("./assets/background.png");
-        coin_texture_id =
-            m_engine->get_systems()->renderer.new_texture_from_file("./assets/coin.png");
+        texture_ids = m_engine->get_systems()->renderer->new_textures(images);
     }
     catch (std::exception &e)
     {
         spdlog::error("Game::init: failed to create textures: {}", e.what());
         return false;
     }
+    TextureId knight_texture_id = texture_ids[0];
+    TextureId bg_texture_id = texture_ids[2];
+    m_block_texture_id = texture_ids[1];
+    m_coin_texture_id = texture_ids[3];
+
+    std::optional<WavData> jump_wav = wav_futures[0].get();
+    std::optional<WavData> pickup_coin_wav = wav_futures[1].get();
+    if (!jump_wav || !pickup_coin_wav)
+    {
+        spdlog::error("Game::init: failed to load wav files");
+        return false;
+    }
+
+    auto jump_source = m_engine->get_systems()->audio->new_source(std::move(*jump_wav));
+    auto pickup_coin_source =
+        m_engine->get_systems()->audio->new_source(std::move(*pickup_coin_wav));
+    if (!jump_source || !pickup_coin_source)
+    {
+        spdlog::error("Game::init: failed to create audio sources");
+        return false;
+    }
+
+    m_jump_wav = *jump_source;
+    m_pickup_coin_wav = *pickup_coin_source;
+    spdlog::info(
+        "Game::init: loaded {} images and {} sounds in {:.3f}ms",
+        image_futures.size(),
+        wav_futures.size(),
+        static_cast<double>(SDL_GetTicksNS() - load_start_ns) / 1e6
+    );
 
+    m_entities.ctx().emplace<SpatialGrid>(SPATIAL_GRID_CELL_SIZE);
+    m_entities.on_construct<Sprite>().connect<&Game::on_add_sprite>(this);
+    m_entities.on_destroy<Sprite>().connect<&Game::on_remove_sprite>(this);
     m_entities.on_construct<Collider>().connect<&Game::on_add_collider>(this);
     m_entities.on_destroy<Collider>().connect<&Game::on_remove_collider>(this);
 
-    for (size_t row_idx = 0; row_idx < map.size(); ++row_idx)
+    uint64_t level_start_ns = SDL_GetTicksNS();
+    const AssetPack &pack = m_engine->get_systems()->asset_pack;
+    if (auto cooked_level = pack.get_blob(get_pack_name(COOKED_LEVEL_PATH)))
     {
-        const auto &row = map[row_idx];
-        for (size_t col_idx = 0; col_idx < 40; ++col_idx)
-        {
-            auto x = col_idx * 16.0f;
-            auto y = VIEWPORT_HEIGHT - (row_idx + 1) * 16.0f;
-            const auto cell = row[col_idx];
-            switch (cell)
-            {
-                case '#': {
-                    auto block = m_entities.create();
-                    m_entities.emplace<Transform>(block, glm::vec2(x, y));
-                    m_entities.emplace<Sprite>(block, block_texture_id, glm::ivec2(16, 16));
-                    m_entities.emplace<Collider>(
-                        block,
-                        Collider{
-                            .type = Collider::Type::statik,
-                            .shape = Collider::Shape::rectangle(glm::vec2(16.0, 16.0)),
-                        }
-                    );
-                    break;
-                }
-                case 'P': {
-                    auto knight = m_entities.create();
-                    m_entities.emplace<Player>(knight);
-                    m_entities.emplace<Transform>(knight, glm::vec2(x, y));
-                    m_entities.emplace<Sprite>(knight, knight_texture_id, glm::ivec2(19, 19));
-                    m_entities.emplace<Collider>(
-                        knight,
-                        Collider{
-                            .type = Collider::Type::dynamic,
-                            .shape = Collider::Shape::circle(19.0f / 2.0f),
-                            .gravity = false,
-                        }
-                    );
-                    break;
-                }
-                case 'C': {
-                    auto coin = m_entities.create();
-                    m_entities.emplace<Coin>(coin);
-                    m_entities.emplace<Transform>(coin, glm::vec2(x, y));
-                    m_entities.emplace<Sprite>(coin, coin_texture_id, glm::ivec2(16, 16));
-                    m_entities.emplace<Collider>(
-                        coin,
-                        Collider{
-                            .type = Collider::Type::statik,
-                            .shape = Collider::Shape::circle(8.0f),
-                            .overlap_only = true,
-                        }
-                    );
-                    break;
-                }
-                case ' ':
-                    break;
-                default:
-                    spdlog::error("Game::init: invalid cell in map: `{}`", cell);
-                    return false;
-            }
-        }
+        m_level = parse_level(*cooked_level);
+    }
+    else
+    {
+        m_level = load_level_file(std::string(LEVEL_PATH));
+    }
+    if (!m_level || !validate_level(*m_level))
+    {
+        spdlog::error("Game::init: failed to load level");
+        return false;
+    }
+    spdlog::info(
+        "Game::init: loaded {}x{} level with {} layers and {} spawns in {:.3f}ms",
+        m_level->width,
+        m_level->height,
+        m_level->layers.size(),
+        m_level->spawns.size(),
+        static_cast<double>(SDL_GetTicksNS() - level_start_ns) / 1e6
+    );
+
+    m_tilemap.emplace(m_level->width, m_level->height, TILE_SIZE, glm::vec2(0.0f));
+    m_engine->get_systems()->renderer->set_tilemap(&*m_tilemap);
+
+    auto player_spawn =
+        std::find_if(m_level->spawns.begin(), m_level->spawns.end(), [](const auto &spawn) {
+            return spawn.type == LevelSpawnType::player;
+        });
+    if (player_spawn == m_level->spawns.end())
+    {
+        spdlog::error("Game::init: level has no player spawn");
+        return false;
     }
 
+    m_prefabs.add(
+        "player",
+        Prefab{
+            .sprite = Sprite{.texture_id = knight_texture_id, .size = glm::ivec2(19, 19)},
+            .collider =
+                Collider{
+                    .type = Collider::Type::dynamic,
+                    .shape = Collider::Shape::circle(19.0f / 2.0f),
+                    // the world's gravity is too weak for the player to jump like a platformer
+                    .gravity_scale = 100.0f,
+                },
+            .components = {prefab_component<Player>()},
+        }
+    );
+    m_prefabs.add(
+        "coin",
+        Prefab{
+            .sprite = Sprite{.texture_id = m_coin_texture_id, .size = glm::ivec2(16, 16)},
+            .collider =
+                Collider{
+                    .type = Collider::Type::statik,
+                    .shape = Collider::Shape::circle(8.0f),
+                    .overlap_only = true,
+                },
+            .components = {prefab_component<Coin>()},
+        }
+    );
+    m_spawner.emplace(&m_engine->get_systems()->physics);
+
+    glm::vec2 player_position = m_tilemap->get_tile_position(player_spawn->x, player_spawn->y);
+    entt::entity knight;
+    m_spawner->spawn(m_entities, *m_prefabs.find("player"), {&player_position, 1}, {&knight, 1});
+
     auto bg = m_entities.create();
     m_entities.emplace<Transform>(bg, glm::vec2(0.0f));
     m_entities.emplace<Sprite>(
@@ -150,44 +186,48 @@ bool Game::init()
         }
     );
 
+    m_level_streamer.emplace(
+        &*m_level,
+        &m_engine->get_systems()->thread_pool,
+        TILE_SIZE,
+        m_tilemap->get_origin(),
+        STREAM_LOAD_MARGIN,
+        STREAM_UNLOAD_MARGIN
+    );
+    update_camera();
+    stream_level(true);
+    add_update_systems();
+    spdlog::info(
+        "Game::init: loaded {} of {} level regions around the player",
+        m_level_streamer->get_loaded_region_count(),
+        m_level_streamer->get_region_count()
+    );
+
     return true;
 }
 
-void Game::update(double delta_time)
+void Game::update(double)
 {
-    auto colliders = m_entities.view<Transform, const Collider>();
-    for (const auto [entity, transform, collider] : colliders.each())
-    {
-        transform.position = m_engine->get_systems()->physics.get_position(collider);
-    }
-
-    auto players = m_entities.view<const Player, Collider, Sprite>();
-
-    auto coins = m_entities.view<const Coin, const Collider>();
-    for (const auto [entity, collider] : coins.each())
-    {
-        auto other_ids = m_engine->get_systems()->physics.get_contact_others(collider);
+    PROFILE_ZONE("Game::update");
+    m_update_systems.run();
+    apply_commands();
+}
 
-        bool hit_player = false;
-        for (const auto &other_id : other_ids)
-        {
-            for (const auto [player_entity, player_collider, player_sprite] : players.each())
-            {
-                if (other_id == player_collider.id.value())
-                {
-                    hit_player = true;
-                    goto done;
-                }
-            }
-        }
+void Game::add_update_systems()
+{
+    m_update_systems.add("Game::stream_level", [this] { stream_level(false); }).structural();
+    m_update_systems.add("Game::control_players", [this] { control_players(); })
+        .reads<Player, Collider>()
+        .writes<Sprite>()
+        .reads_resource<Input>()
+        .writes_resource<Physics>();
+    // sounds are played through `Audio`'s command queue, which any system may push to at once
+    m_update_systems.build(m_entities);
+}
 
-    done:
-        if (hit_player)
-        {
-            m_entities.destroy(entity);
-            m_entities.emplace<AudioPlayer>(m_entities.create(), m_pickup_coin_wav);
-        }
-    }
+void Game::control_players()
+{
+    auto players = m_entities.view<const Player, const Collider, Sprite>();
 
     float player_speed = 400.0;
     for (const auto [entity, collider, sprite] : players.each())
@@ -210,41 +250,299 @@ void Game::update(double delta_time)
             m_engine->get_systems()->physics.get_contact_normal(collider);
         bool grounded =
             contact_normal.has_value() && contact_normal->y > 0.0f && contact_normal->x < 0.1;
-        if (!grounded)
-        {
-            velocity.y -= 1000.0f * delta_time;
-        }
-        else if (m_engine->get_systems()->input.was_just_pressed(SDL_SCANCODE_SPACE))
+        if (grounded && m_engine->get_systems()->input.was_just_pressed(SDL_SCANCODE_SPACE))
         {
-            m_entities.emplace<AudioPlayer>(m_entities.create(), m_jump_wav);
+            m_engine->get_systems()->audio->play(m_jump_wav);
             velocity.y = 400.0f;
         }
 
         m_engine->get_systems()->physics.set_velocity(collider, velocity);
     }
+}
+
+void Game::apply_commands()
+{
+    m_commands.flush(m_entities, m_engine->get_systems()->physics);
+}
+
+void Game::post_physics_step()
+{
+    PROFILE_ZONE("Game::post_physics_step");
+    CommandBuffer &commands = m_commands.local();
+    for (const auto &event : m_engine->get_systems()->physics.get_sensor_begin_events())
+    {
+        if (m_entities.valid(event.sensor) && m_entities.all_of<Coin>(event.sensor) &&
+            m_entities.valid(event.visitor) && m_entities.all_of<Player>(event.visitor))
+        {
+            if (const auto *spawn = m_entities.try_get<const LevelSpawnRef>(event.sensor))
+            {
+                m_collected_spawns.insert(spawn->spawn);
+            }
+            commands.destroy(event.sensor);
+            m_engine->get_systems()->audio->play(m_pickup_coin_wav);
+        }
+    }
+    apply_commands();
 
-    auto audio_players = m_entities.view<const AudioPlayer>();
-    for (const auto [entity, player] : audio_players.each())
+    // every body that is not in `m_moving_bodies` has its previous position equal to its
+    // current one, so only bodies that moved last step need to be brought up to date
+    for (const auto entity : m_moving_bodies)
     {
-        m_engine->get_systems()->audio.play(player.source);
-        m_entities.destroy(entity);
+        if (!m_entities.valid(entity))
+        {
+            continue;
+        }
+        if (auto *interpolation = m_entities.try_get<PhysicsInterpolation>(entity))
+        {
+            interpolation->previous_position = interpolation->current_position;
+            m_settled_bodies.push_back(entity);
+        }
+    }
+    m_moving_bodies.clear();
+
+    for (const auto &event : m_engine->get_systems()->physics.get_move_events())
+    {
+        if (!m_entities.valid(event.entity))
+        {
+            continue;
+        }
+        if (auto *interpolation = m_entities.try_get<PhysicsInterpolation>(event.entity))
+        {
+            interpolation->current_position = event.position;
+            m_moving_bodies.push_back(event.entity);
+        }
     }
 }
 
+void Game::interpolate_transforms(float alpha)
+{
+    PROFILE_ZONE("Game::interpolate_transforms");
+    auto &grid = m_entities.ctx().get<SpatialGrid>();
+    auto bodies = m_entities.view<Transform, const PhysicsInterpolation>();
+    auto update_grid = [&](entt::entity entity, const Transform &transform) {
+        if (const auto *sprite = m_entities.try_get<const Sprite>(entity))
+        {
+            grid.update(entity, get_sprite_bounds(transform, *sprite));
+        }
+    };
+
+    for (const auto entity : m_settled_bodies)
+    {
+        if (bodies.contains(entity))
+        {
+            const auto [transform, interpolation] = bodies.get(entity);
+            transform.position = interpolation.current_position;
+            update_grid(entity, transform);
+        }
+    }
+    m_settled_bodies.clear();
+
+    for (const auto entity : m_moving_bodies)
+    {
+        if (bodies.contains(entity))
+        {
+            const auto [transform, interpolation] = bodies.get(entity);
+            transform.position =
+                glm::mix(interpolation.previous_position, interpolation.current_position, alpha);
+            update_grid(entity, transform);
+        }
+    }
+
+    update_camera();
+}
+
 const entt::registry &Game::get_entities() const
 {
     return m_entities;
 }
 
+void Game::update_camera()
+{
+    m_camera.size = glm::vec2(VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+
+    // keep the view inside the level, or at its bottom-left corner if the level is smaller
+    glm::vec2 level_size = glm::vec2(m_tilemap->get_width(), m_tilemap->get_height()) * TILE_SIZE;
+    glm::vec2 min_position = m_tilemap->get_origin();
+    glm::vec2 max_position = glm::max(min_position, min_position + level_size - m_camera.size);
+    for (const auto [entity, transform] : m_entities.view<const Player, const Transform>().each())
+    {
+        m_camera.position =
+            glm::clamp(transform.position - m_camera.size / 2.0f, min_position, max_position);
+    }
+    m_engine->get_systems()->renderer->set_camera(m_camera);
+}
+
+void Game::stream_level(bool wait)
+{
+    PROFILE_ZONE("Game::stream_level");
+    m_loaded_regions.clear();
+    m_unloaded_regions.clear();
+    m_level_streamer->update(m_camera.get_bounds(), wait, m_loaded_regions, m_unloaded_regions);
+
+    for (uint32_t region : m_unloaded_regions)
+    {
+        unload_region(region);
+    }
+    // removes the bodies of every unloaded coin at once
+    apply_commands();
+    for (const auto &data : m_loaded_regions)
+    {
+        load_region(data);
+    }
+
+    if (!m_loaded_regions.empty() || !m_unloaded_regions.empty())
+    {
+        spdlog::trace(
+            "Game::stream_level: loaded {} and unloaded {} regions, {} in the world",
+            m_loaded_regions.size(),
+            m_unloaded_regions.size(),
+            m_streamed_regions.size()
+        );
+    }
+}
+
+void Game::load_region(const LevelRegionData &data)
+{
+    StreamedRegion streamed;
+
+    TileRect tiles = m_level_streamer->get_region_tiles(data.region);
+    for (uint32_t y = tiles.y; y < tiles.y + tiles.height; ++y)
+    {
+        for (uint32_t x = tiles.x; x < tiles.x + tiles.width; ++x)
+        {
+            // there is a single tile texture, so a tile is drawn if any layer has one
+            for (uint32_t layer = 0; layer < m_level->layers.size(); ++layer)
+            {
+                if (m_level->get_tile(layer, x, y) == LevelTile::block)
+                {
+                    m_tilemap->set(x, y, m_block_texture_id);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!data.solid_rects.empty())
+    {
+        std::vector<PhysicsBox> boxes;
+        boxes.reserve(data.solid_rects.size());
+        for (const auto &rect : data.solid_rects)
+        {
+            // tile colliders are centered on the tile's position, same as entity colliders
+            glm::vec2 first = m_tilemap->get_tile_position(rect.x, rect.y);
+            glm::vec2 extent(rect.width - 1.0f, 1.0f - rect.height);
+            boxes.push_back(PhysicsBox{
+                .center = first + extent * TILE_SIZE / 2.0f,
+                .size = glm::vec2(rect.width, rect.height) * TILE_SIZE,
+            });
+        }
+        streamed.body = m_engine->get_systems()->physics.add_static_boxes(boxes);
+    }
+
+    m_spawn_positions.clear();
+    m_spawn_refs.clear();
+    for (uint32_t spawn_idx : data.spawns)
+    {
+        const LevelSpawn &spawn = m_level->spawns[spawn_idx];
+        if (spawn.type != LevelSpawnType::coin || m_collected_spawns.contains(spawn_idx))
+        {
+            continue;
+        }
+        m_spawn_positions.push_back(m_tilemap->get_tile_position(spawn.x, spawn.y));
+        m_spawn_refs.push_back(LevelSpawnRef{.spawn = spawn_idx});
+    }
+
+    if (!m_spawn_positions.empty())
+    {
+        m_spawned_entities.resize(m_spawn_positions.size());
+        m_spawner->spawn(
+            m_entities,
+            *m_prefabs.find("coin"),
+            m_spawn_positions,
+            m_spawned_entities
+        );
+        m_entities.insert<LevelSpawnRef>(
+            m_spawned_entities.begin(),
+            m_spawned_entities.end(),
+            m_spawn_refs.begin()
+        );
+        streamed.entities = m_spawned_entities;
+    }
+
+    m_streamed_regions.emplace(data.region, std::move(streamed));
+}
+
+void Game::unload_region(uint32_t region)
+{
+    auto it = m_streamed_regions.find(region);
+    if (it == m_streamed_regions.end())
+    {
+        return;
+    }
+
+    // coins that were picked up are already gone, the command buffer skips them
+    CommandBuffer &commands = m_commands.local();
+    for (auto entity : it->second.entities)
+    {
+        commands.destroy(entity);
+    }
+    if (it->second.body)
+    {
+        m_engine->get_systems()->physics.remove_body(*it->second.body);
+    }
+
+    TileRect tiles = m_level_streamer->get_region_tiles(region);
+    for (uint32_t y = tiles.y; y < tiles.y + tiles.height; ++y)
+    {
+        for (uint32_t x = tiles.x; x < tiles.x + tiles.width; ++x)
+        {
+            m_tilemap->set(x, y, std::nullopt);
+        }
+    }
+
+    m_streamed_regions.erase(it);
+}
+
+void Game::on_add_sprite(entt::registry &registry, entt::entity entity)
+{
+    if (const auto *transform = registry.try_get<const Transform>(entity))
+    {
+        registry.ctx().get<SpatialGrid>().insert(
+            entity,
+            get_sprite_bounds(*transform, registry.get<const Sprite>(entity))
+        );
+    }
+}
+
+void Game::on_remove_sprite(entt::registry &registry, entt::entity entity)
+{
+    registry.ctx().get<SpatialGrid>().remove(entity);
+}
+
 void Game::on_add_collider(entt::registry &registry, entt::entity entity)
 {
-    const auto &transform = registry.get<const Transform>(entity);
     auto &collider = registry.get<Collider>(entity);
-    m_engine->get_systems()->physics.add(transform, collider);
+    // spawned in bulk by `PrefabSpawner`, which created the body and interpolation already
+    if (collider.id)
+    {
+        return;
+    }
+
+    const auto &transform = registry.get<const Transform>(entity);
+    m_engine->get_systems()->physics.add(entity, transform, collider);
+
+    if (collider.type == Collider::Type::dynamic)
+    {
+        registry.emplace<PhysicsInterpolation>(entity, transform.position, transform.position);
+    }
 }
 
 void Game::on_remove_collider(entt::registry &registry, entt::entity entity)
 {
     auto &collider = registry.get<Collider>(entity);
-    m_engine->get_systems()->physics.remove(collider);
+    // destroyed through `CommandBuffers`, which removed the body already
+    if (collider.id)
+    {
+        m_engine->get_systems()->physics.remove(collider);
+    }
 }
@@ -1,9 +1,22 @@
 #pragma once
 
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 
 #include "audio.hpp"
+#include "camera.hpp"
+#include "command_buffer.hpp"
+#include "level.hpp"
+#include "level_streamer.hpp"
+#include "physics.hpp"
+#include "prefab.hpp"
+#include "system_graph.hpp"
+#include "tilemap.hpp"
 
 class Engine;
 
@@ -12,26 +25,85 @@ class Game
   public:
     static constexpr int VIEWPORT_WIDTH = 640;
     static constexpr int VIEWPORT_HEIGHT = 368;
+    static constexpr float SPATIAL_GRID_CELL_SIZE = 128.0f;
+    static constexpr float TILE_SIZE = 16.0f;
+    // regions are loaded within half a region of the view and unloaded a full region away
+    static constexpr float STREAM_LOAD_MARGIN = LevelStreamer::REGION_SIZE * TILE_SIZE / 2.0f;
+    static constexpr float STREAM_UNLOAD_MARGIN = LevelStreamer::REGION_SIZE * TILE_SIZE;
 
   private:
+    // what a loaded region added to the world, so it can be taken out again
+    struct StreamedRegion
+    {
+        std::optional<PhysicsBodyId> body;
+        std::vector<entt::entity> entities;
+    };
+
     Engine *m_engine;
     entt::registry m_entities;
+    SystemGraph m_update_systems;
+    // structural changes made while iterating views, applied at the sync points of a frame
+    CommandBuffers m_commands;
 
     AudioSourceId m_jump_wav;
     AudioSourceId m_pickup_coin_wav;
 
+    TextureId m_block_texture_id;
+    TextureId m_coin_texture_id;
+
+    PrefabLibrary m_prefabs;
+    std::optional<PrefabSpawner> m_spawner;
+    std::vector<glm::vec2> m_spawn_positions;
+    std::vector<entt::entity> m_spawned_entities;
+    std::vector<LevelSpawnRef> m_spawn_refs;
+
+    Camera m_camera;
+    std::optional<Level> m_level;
+    std::optional<Tilemap> m_tilemap;
+    std::optional<LevelStreamer> m_level_streamer;
+    std::unordered_map<uint32_t, StreamedRegion> m_streamed_regions;
+    // coins that were picked up stay gone when their region is loaded again
+    std::unordered_set<uint32_t> m_collected_spawns;
+    std::vector<LevelRegionData> m_loaded_regions;
+    std::vector<uint32_t> m_unloaded_regions;
+
+    // bodies that moved during the most recent physics step
+    std::vector<entt::entity> m_moving_bodies;
+    // bodies that stopped moving since the last `interpolate_transforms` and still need their
+    // transform set to their final position
+    std::vector<entt::entity> m_settled_bodies;
+
   public:
-    Game(Engine *engine) : m_engine(engine)
-    {
-    }
+    Game(Engine *engine);
 
     bool init();
 
     void update(double delta_time);
 
+    void post_physics_step();
+
+    void interpolate_transforms(float alpha);
+
     const entt::registry &get_entities() const;
 
   private:
+    void add_update_systems();
+
+    void control_players();
+
+    void apply_commands();
+
+    void update_camera();
+
+    // with `wait`, blocks until every region near the camera is in the world
+    void stream_level(bool wait);
+
+    void load_region(const LevelRegionData &data);
+
+    void unload_region(uint32_t region);
+
+    void on_add_sprite(entt::registry &registry, entt::entity entity);
+    void on_remove_sprite(entt::registry &registry, entt::entity entity);
     void on_add_collider(entt::registry &registry, entt::entity entity);
     void on_remove_collider(entt::registry &registry, entt::entity entity);
 };
@@ -0,0 +1,170 @@
+#include "gpu_renderer.hpp"
+
+#include <SDL3/SDL_video.h>
+#include <spdlog/spdlog.h>
+
+#include "profiler.hpp"
+
+bool GPURenderer::init(SDL_Window *window, const AssetPack *asset_pack)
+{
+    m_window = window;
+    m_gpu_context.asset_pack = asset_pack;
+
+    m_gpu_context.device = SDL_CreateGPUDevice(SDL_GPU_SHADERFORMAT_SPIRV, true, nullptr);
+    if (!m_gpu_context.device)
+    {
+        spdlog::error("GPURenderer::init: failed to create gpu device: {}", SDL_GetError());
+        return false;
+    }
+    spdlog::trace("GPURenderer::init: created sdl gpu device");
+    spdlog::info(
+        "GPURenderer::init: using graphics backend: {}",
+        SDL_GetGPUDeviceDriver(m_gpu_context.device)
+    );
+
+    if (!SDL_ClaimWindowForGPUDevice(m_gpu_context.device, window))
+    {
+        spdlog::error(
+            "GPURenderer::init: failed to claim window for gpu device: {}",
+            SDL_GetError()
+        );
+        return false;
+    }
+    spdlog::trace("GPURenderer::init: claimed window for gpu device");
+
+    if (!m_gpu_context.uploads.init(m_gpu_context.device, UPLOAD_RING_SIZE))
+    {
+        spdlog::error("GPURenderer::init: failed to initialize upload ring");
+        return false;
+    }
+    spdlog::trace("GPURenderer::init: initialized upload ring");
+
+    if (!m_gpu_context.atlas.init(m_gpu_context.device, &m_gpu_context.uploads))
+    {
+        spdlog::error("GPURenderer::init: failed to initialize texture atlas");
+        return false;
+    }
+    spdlog::trace("GPURenderer::init: initialized texture atlas");
+
+    int width, height;
+    SDL_GetWindowSize(m_window, &width, &height);
+    if (!m_sprite_render_pass
+             .init(SDL_GetGPUSwapchainTextureFormat(m_gpu_context.device, m_window), width, height))
+    {
+        spdlog::error("GPURenderer::init: failed to initialize sprite render pass");
+        return false;
+    }
+    spdlog::trace("GPURenderer::init: initialized sprite render pass");
+
+    m_gpu_context.asset_pack = nullptr;
+
+    return true;
+}
+
+bool GPURenderer::set_present_mode(PresentMode mode)
+{
+    SDL_GPUPresentMode present_mode = SDL_GPU_PRESENTMODE_VSYNC;
+    switch (mode)
+    {
+    case PresentMode::vsync:
+        present_mode = SDL_GPU_PRESENTMODE_VSYNC;
+        break;
+    case PresentMode::mailbox:
+        present_mode = SDL_GPU_PRESENTMODE_MAILBOX;
+        break;
+    case PresentMode::immediate:
+        present_mode = SDL_GPU_PRESENTMODE_IMMEDIATE;
+        break;
+    }
+
+    if (!SDL_WindowSupportsGPUPresentMode(m_gpu_context.device, m_window, present_mode))
+    {
+        spdlog::warn(
+            "GPURenderer::set_present_mode: {} is not supported",
+            get_present_mode_name(mode)
+        );
+        return false;
+    }
+    if (!SDL_SetGPUSwapchainParameters(
+            m_gpu_context.device,
+            m_window,
+            SDL_GPU_SWAPCHAINCOMPOSITION_SDR,
+            present_mode
+        ))
+    {
+        spdlog::error(
+            "GPURenderer::set_present_mode: failed to set {}: {}",
+            get_present_mode_name(mode),
+            SDL_GetError()
+        );
+        return false;
+    }
+    return true;
+}
+
+bool GPURenderer::set_frames_in_flight(uint32_t count)
+{
+    if (!SDL_SetGPUAllowedFramesInFlight(m_gpu_context.device, count))
+    {
+        spdlog::error(
+            "GPURenderer::set_frames_in_flight: failed to allow {} frames: {}",
+            count,
+            SDL_GetError()
+        );
+        return false;
+    }
+    return true;
+}
+
+void GPURenderer::render(const entt::registry &entities)
+{
+    PROFILE_ZONE("GPURenderer::render");
+    m_gpu_context.uploads.reclaim();
+
+    SDL_GPUCommandBuffer *cmd_buf = SDL_AcquireGPUCommandBuffer(m_gpu_context.device);
+    if (!cmd_buf)
+    {
+        spdlog::error(
+            "GPURenderer::render: failed to acquire gpu command buffer: {}",
+            SDL_GetError()
+        );
+        return;
+    }
+
+    SDL_GPUTexture *swapchain_texture;
+    if (!SDL_AcquireGPUSwapchainTexture(cmd_buf, m_window, &swapchain_texture, nullptr, nullptr))
+    {
+        spdlog::error(
+            "GPURenderer::render: failed to acquire gpu swapchain texture: {}",
+            SDL_GetError()
+        );
+        return;
+    }
+
+    m_sprite_render_pass.render(cmd_buf, swapchain_texture, m_camera, entities);
+
+    m_gpu_context.uploads.submit(cmd_buf);
+}
+
+[[nodiscard]] std::vector<TextureId> GPURenderer::new_textures(std::span<const ImageData> images)
+{
+    std::vector<TextureId> ids;
+    ids.reserve(images.size());
+    for (auto &region : m_gpu_context.atlas.add(images))
+    {
+        ids.push_back(m_gpu_context.textures.insert(region));
+    }
+    return ids;
+}
+
+void GPURenderer::free_textures(std::span<const TextureId> ids)
+{
+    for (TextureId id : ids)
+    {
+        if (const AtlasRegion *region = m_gpu_context.textures.find(id))
+        {
+            m_gpu_context.atlas.remove(*region);
+            m_gpu_context.textures.erase(id);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <SDL3/SDL_gpu.h>
+#include <SDL3/SDL_video.h>
+#include <entt/entt.hpp>
+
+#include "asset_pack.hpp"
+#include "gpu_upload_ring.hpp"
+#include "renderer.hpp"
+#include "slot_map.hpp"
+#include "sprite_render_pass.hpp"
+#include "texture_atlas.hpp"
+
+struct GPUContext
+{
+    SDL_GPUDevice *device{nullptr};
+    const AssetPack *asset_pack{nullptr};
+    GPUUploadRing uploads;
+    TextureAtlas atlas;
+    SlotMap<AtlasRegion> textures;
+};
+
+class GPURenderer final : public Renderer
+{
+    // enough for a few frames of sprite instances and the textures loaded at startup
+    static constexpr uint32_t UPLOAD_RING_SIZE = 16 * 1024 * 1024;
+
+    SDL_Window *m_window{nullptr};
+    GPUContext m_gpu_context;
+
+    Camera m_camera;
+    SpriteRenderPass m_sprite_render_pass;
+
+  public:
+    GPURenderer() : m_sprite_render_pass(&m_gpu_context)
+    {
+    }
+
+    ~GPURenderer() override
+    {
+        if (m_gpu_context.device != nullptr)
+        {
+            m_sprite_render_pass.release();
+            m_gpu_context.atlas.release();
+            m_gpu_context.uploads.release();
+
+            SDL_DestroyGPUDevice(m_gpu_context.device);
+        }
+    }
+
+    // `asset_pack` is used for shaders when it is open, it is only read during `init`
+    [[nodiscard]] bool init(SDL_Window *window, const AssetPack *asset_pack);
+
+    void render(const entt::registry &entities) override;
+
+    void set_camera(const Camera &camera) override
+    {
+        m_camera = camera;
+    }
+
+    bool set_present_mode(PresentMode mode) override;
+
+    bool set_frames_in_flight(uint32_t count) override;
+
+    void set_tilemap(Tilemap *tilemap) override
+    {
+        m_sprite_render_pass.set_tilemap(tilemap);
+    }
+
+    [[nodiscard]] std::vector<TextureId> new_textures(std::span<const ImageData> images) override;
+
+    void free_textures(std::span<const TextureId> ids) override;
+};
@@ -0,0 +1,183 @@
+#include "gpu_upload_ring.hpp"
+
+#include <spdlog/spdlog.h>
+
+bool GPUUploadRing::init(SDL_GPUDevice *device, uint32_t capacity)
+{
+    m_device = device;
+    m_ring = UploadRing(capacity);
+
+    SDL_GPUTransferBufferCreateInfo transfer_buf_create_info{
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = capacity,
+        .props = 0,
+    };
+    m_transfer_buffer = SDL_CreateGPUTransferBuffer(m_device, &transfer_buf_create_info);
+    if (!m_transfer_buffer)
+    {
+        spdlog::error("GPUUploadRing::init: failed to create transfer buffer: {}", SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
+void GPUUploadRing::release()
+{
+    unmap();
+
+    for (const auto &in_flight : m_in_flight)
+    {
+        SDL_WaitForGPUFences(m_device, true, &in_flight.fence, 1);
+        SDL_ReleaseGPUFence(m_device, in_flight.fence);
+    }
+    m_in_flight.clear();
+
+    for (auto *transfer_buffer : m_dedicated)
+    {
+        SDL_ReleaseGPUTransferBuffer(m_device, transfer_buffer);
+    }
+    m_dedicated.clear();
+    m_first_mapped_dedicated = 0;
+
+    if (m_transfer_buffer != nullptr)
+    {
+        SDL_ReleaseGPUTransferBuffer(m_device, m_transfer_buffer);
+        m_transfer_buffer = nullptr;
+    }
+}
+
+void GPUUploadRing::reclaim()
+{
+    while (!m_in_flight.empty() && SDL_QueryGPUFence(m_device, m_in_flight.front().fence))
+    {
+        m_ring.release(m_in_flight.front().submission_id);
+        SDL_ReleaseGPUFence(m_device, m_in_flight.front().fence);
+        m_in_flight.pop_front();
+    }
+}
+
+std::optional<UploadAllocation> GPUUploadRing::allocate(uint32_t size, uint32_t alignment)
+{
+    std::optional<uint64_t> offset = m_ring.allocate(size, alignment);
+    while (!offset && !m_in_flight.empty())
+    {
+        // the oldest submission frees the space that is reused next
+        SDL_WaitForGPUFences(m_device, true, &m_in_flight.front().fence, 1);
+        reclaim();
+        offset = m_ring.allocate(size, alignment);
+    }
+    if (!offset)
+    {
+        return allocate_dedicated(size);
+    }
+
+    if (m_mapped == nullptr)
+    {
+        // no cycling, the ring guarantees the GPU is not reading the ranges written from now on
+        m_mapped =
+            static_cast<uint8_t *>(SDL_MapGPUTransferBuffer(m_device, m_transfer_buffer, false));
+        if (m_mapped == nullptr)
+        {
+            spdlog::error(
+                "GPUUploadRing::allocate: failed to map transfer buffer: {}",
+                SDL_GetError()
+            );
+            return {};
+        }
+    }
+    m_has_pending = true;
+
+    return UploadAllocation{
+        .transfer_buffer = m_transfer_buffer,
+        .offset = static_cast<uint32_t>(*offset),
+        .data = m_mapped + *offset,
+    };
+}
+
+std::optional<UploadAllocation> GPUUploadRing::allocate_dedicated(uint32_t size)
+{
+    SDL_GPUTransferBufferCreateInfo transfer_buf_create_info{
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = size,
+        .props = 0,
+    };
+    SDL_GPUTransferBuffer *transfer_buffer =
+        SDL_CreateGPUTransferBuffer(m_device, &transfer_buf_create_info);
+    if (!transfer_buffer)
+    {
+        spdlog::error(
+            "GPUUploadRing::allocate_dedicated: failed to create transfer buffer: {}",
+            SDL_GetError()
+        );
+        return {};
+    }
+
+    auto *data = static_cast<uint8_t *>(SDL_MapGPUTransferBuffer(m_device, transfer_buffer, false));
+    if (data == nullptr)
+    {
+        spdlog::error(
+            "GPUUploadRing::allocate_dedicated: failed to map transfer buffer: {}",
+            SDL_GetError()
+        );
+        SDL_ReleaseGPUTransferBuffer(m_device, transfer_buffer);
+        return {};
+    }
+    m_dedicated.push_back(transfer_buffer);
+    spdlog::debug("GPUUploadRing::allocate_dedicated: {} bytes do not fit into the ring", size);
+
+    return UploadAllocation{
+        .transfer_buffer = transfer_buffer,
+        .offset = 0,
+        .data = data,
+    };
+}
+
+void GPUUploadRing::unmap()
+{
+    if (m_mapped != nullptr)
+    {
+        SDL_UnmapGPUTransferBuffer(m_device, m_transfer_buffer);
+        m_mapped = nullptr;
+    }
+
+    // each dedicated buffer is mapped once when it is created, so it is only unmapped once
+    for (size_t i = m_first_mapped_dedicated; i < m_dedicated.size(); ++i)
+    {
+        SDL_UnmapGPUTransferBuffer(m_device, m_dedicated[i]);
+    }
+    m_first_mapped_dedicated = m_dedicated.size();
+}
+
+bool GPUUploadRing::submit(SDL_GPUCommandBuffer *cmd_buffer)
+{
+    unmap();
+
+    // dedicated buffers are only destroyed once the GPU is done with them
+    for (auto *transfer_buffer : m_dedicated)
+    {
+        SDL_ReleaseGPUTransferBuffer(m_device, transfer_buffer);
+    }
+    m_dedicated.clear();
+    m_first_mapped_dedicated = 0;
+
+    if (!m_has_pending)
+    {
+        return SDL_SubmitGPUCommandBuffer(cmd_buffer);
+    }
+    m_has_pending = false;
+
+    uint64_t submission_id = m_ring.submit();
+    SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmd_buffer);
+    if (fence == nullptr)
+    {
+        spdlog::error("GPUUploadRing::submit: failed to submit command buffer: {}", SDL_GetError());
+        // without a fence there is no telling when the space is free again, wait for everything
+        SDL_WaitForGPUIdle(m_device);
+        m_ring.release(submission_id);
+        return false;
+    }
+
+    m_in_flight.push_back(InFlight{.submission_id = submission_id, .fence = fence});
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include <SDL3/SDL_gpu.h>
+
+#include "upload_ring.hpp"
+
+struct UploadAllocation
+{
+    SDL_GPUTransferBuffer *transfer_buffer;
+    uint32_t offset;
+    uint8_t *data;
+};
+
+// One persistent upload transfer buffer shared by every upload. Space is handed out through an
+// `UploadRing` and reclaimed once the fence of the command buffer that consumed it has signaled.
+// Uploads larger than the whole ring get a transfer buffer of their own.
+//
+// Usage: `allocate` and write the data, `unmap` before recording the copy pass that reads it and
+// `submit` the command buffer that contains the copy pass.
+class GPUUploadRing
+{
+    struct InFlight
+    {
+        uint64_t submission_id;
+        SDL_GPUFence *fence;
+    };
+
+    SDL_GPUDevice *m_device{nullptr};
+    SDL_GPUTransferBuffer *m_transfer_buffer{nullptr};
+    UploadRing m_ring{0};
+    uint8_t *m_mapped{nullptr};
+    bool m_has_pending{false};
+
+    std::deque<InFlight> m_in_flight;
+    std::vector<SDL_GPUTransferBuffer *> m_dedicated;
+    // dedicated buffers from this index on are still mapped
+    size_t m_first_mapped_dedicated{0};
+
+  public:
+    [[nodiscard]] bool init(SDL_GPUDevice *device, uint32_t capacity);
+
+    void release();
+
+    // Frees the space of every submission the GPU has finished with.
+    void reclaim();
+
+    // Waits for the GPU when the ring is full.
+    [[nodiscard]] std::optional<UploadAllocation> allocate(uint32_t size, uint32_t alignment = 16);
+
+    void unmap();
+
+    // Submits `cmd_buffer` and ties every allocation since the previous submit to its fence.
+    bool submit(SDL_GPUCommandBuffer *cmd_buffer);
+
+  private:
+    [[nodiscard]] std::optional<UploadAllocation> allocate_dedicated(uint32_t size);
+};
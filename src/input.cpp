@@ -1,15 +1,43 @@
 #include "input.hpp"
 
-#include <algorithm>
-
 void Input::post_update()
 {
-    std::copy(std::begin(m_key_states), std::end(m_key_states), std::begin(m_prev_key_states));
+    for (const auto &transition : m_transitions)
+    {
+        m_press_counts[transition.key] = 0;
+    }
+    m_transitions.clear();
 }
 
-void Input::handle_event(SDL_KeyboardEvent &event)
+void Input::handle_event(const SDL_Event &event)
 {
-    m_key_states[event.scancode] = event.type == SDL_EVENT_KEY_DOWN;
+    if (event.type != SDL_EVENT_KEY_DOWN && event.type != SDL_EVENT_KEY_UP)
+    {
+        return;
+    }
+
+    const SDL_KeyboardEvent &key = event.key;
+    if (key.repeat || key.scancode >= SDL_SCANCODE_COUNT)
+    {
+        return;
+    }
+
+    bool down = event.type == SDL_EVENT_KEY_DOWN;
+    if (m_key_states[key.scancode] == down)
+    {
+        return;
+    }
+
+    m_key_states[key.scancode] = down;
+    if (down && m_press_counts[key.scancode] < UINT8_MAX)
+    {
+        ++m_press_counts[key.scancode];
+    }
+    m_transitions.push_back(KeyTransition{
+        .key = key.scancode,
+        .down = down,
+        .timestamp_ns = key.timestamp,
+    });
 }
 
 [[nodiscard]] bool Input::is_pressed(SDL_Scancode key) const
@@ -19,5 +47,10 @@ void Input::handle_event(SDL_KeyboardEvent &event)
 
 [[nodiscard]] bool Input::was_just_pressed(SDL_Scancode key) const
 {
-    return !m_prev_key_states[key] && m_key_states[key];
+    return m_press_counts[key] > 0;
+}
+
+[[nodiscard]] uint32_t Input::get_press_count(SDL_Scancode key) const
+{
+    return m_press_counts[key];
 }
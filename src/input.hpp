@@ -1,19 +1,43 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
 
 #include <SDL3/SDL.h>
 
+struct KeyTransition
+{
+    SDL_Scancode key;
+    bool down;
+    // same time base as `SDL_GetTicksNS`
+    uint64_t timestamp_ns;
+};
+
+// Keyboard state of the current frame. Every key transition since the last `post_update` is kept
+// in order, so a key that is pressed and released again within one frame was still just pressed.
 class Input
 {
     std::array<bool, SDL_SCANCODE_COUNT> m_key_states{};
-    std::array<bool, SDL_SCANCODE_COUNT> m_prev_key_states{};
+    std::array<uint8_t, SDL_SCANCODE_COUNT> m_press_counts{};
+    std::vector<KeyTransition> m_transitions;
 
   public:
+    // ends the frame, forgetting its transitions
     void post_update();
 
-    void handle_event(SDL_KeyboardEvent &event);
+    // records key presses and releases, other events and key repeats are ignored
+    void handle_event(const SDL_Event &event);
 
     [[nodiscard]] bool is_pressed(SDL_Scancode key) const;
     [[nodiscard]] bool was_just_pressed(SDL_Scancode key) const;
+
+    // how often the key went down this frame, up to 255
+    [[nodiscard]] uint32_t get_press_count(SDL_Scancode key) const;
+
+    [[nodiscard]] std::span<const KeyTransition> get_transitions() const
+    {
+        return m_transitions;
+    }
 };
@@ -0,0 +1,238 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+namespace
+{
+
+// set for the threads started by a job system, the thread that created it is worker 0
+thread_local const JobSystem *t_job_system = nullptr;
+thread_local uint32_t t_worker = 0;
+
+} // namespace
+
+JobSystem::JobSystem(uint32_t worker_count) : m_owner(std::this_thread::get_id())
+{
+    if (worker_count == 0)
+    {
+        worker_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    worker_count = std::min(worker_count, MAX_WORKER_COUNT);
+
+    m_workers.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+
+    m_threads.reserve(worker_count - 1);
+    for (uint32_t i = 1; i < worker_count; ++i)
+    {
+        m_threads.emplace_back([this, i] {
+            t_job_system = this;
+            t_worker = i;
+            run_worker(i);
+        });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard lock(m_sleep_mutex);
+        m_stopping = true;
+    }
+    m_job_available.notify_all();
+
+    for (auto &thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+JobSystem::Task *JobSystem::enqueue(
+    int32_t count, int32_t min_range, JobFunction *function, void *context
+)
+{
+    if (count <= 0)
+    {
+        return nullptr;
+    }
+
+    min_range = std::max(min_range, 1);
+    uint32_t worker = get_current_worker();
+    int64_t max_job_count = static_cast<int64_t>(m_workers.size()) * JOBS_PER_WORKER;
+    int64_t range_count = (static_cast<int64_t>(count) + min_range - 1) / min_range;
+    int64_t job_count = std::min(range_count, max_job_count);
+    if (job_count <= 1)
+    {
+        function(0, count, worker, context);
+        return nullptr;
+    }
+
+    Task *task;
+    {
+        std::lock_guard lock(m_task_mutex);
+        if (m_free_tasks.empty())
+        {
+            m_tasks.push_back(std::make_unique<Task>());
+            m_free_tasks.push_back(m_tasks.back().get());
+        }
+        task = m_free_tasks.back();
+        m_free_tasks.pop_back();
+    }
+    task->function = function;
+    task->context = context;
+    task->remaining_jobs.store(static_cast<uint32_t>(job_count), std::memory_order_relaxed);
+
+    {
+        Worker &queue = *m_workers[worker];
+        std::lock_guard lock(queue.mutex);
+        // The first ranges go on top, so the owner starts at the front like a serial loop would.
+        // Ranges differ in size by at most one item, none is empty as `job_count <= count`.
+        for (int64_t i = job_count - 1; i >= 0; --i)
+        {
+            queue.jobs.push_back(Job{
+                .task = task,
+                .start = static_cast<int32_t>(count * i / job_count),
+                .end = static_cast<int32_t>(count * (i + 1) / job_count),
+            });
+        }
+    }
+
+    {
+        std::lock_guard lock(m_sleep_mutex);
+        m_queued_jobs.fetch_add(static_cast<uint32_t>(job_count), std::memory_order_relaxed);
+    }
+    m_job_available.notify_all();
+    return task;
+}
+
+void JobSystem::wait(Task *task)
+{
+    if (task == nullptr)
+    {
+        return;
+    }
+
+    uint32_t worker = get_current_worker();
+    while (task->remaining_jobs.load(std::memory_order_acquire) > 0)
+    {
+        if (!run_job(worker))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    std::lock_guard lock(m_task_mutex);
+    m_free_tasks.push_back(task);
+}
+
+JobWorkerStats JobSystem::get_worker_stats(uint32_t worker) const
+{
+    const Worker &stats = *m_workers[worker];
+    return JobWorkerStats{
+        .busy_ns = stats.busy_ns.load(std::memory_order_relaxed),
+        .job_count = stats.job_count.load(std::memory_order_relaxed),
+        .steal_count = stats.steal_count.load(std::memory_order_relaxed),
+    };
+}
+
+void JobSystem::reset_stats()
+{
+    for (auto &worker : m_workers)
+    {
+        worker->busy_ns.store(0, std::memory_order_relaxed);
+        worker->job_count.store(0, std::memory_order_relaxed);
+        worker->steal_count.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint32_t JobSystem::get_current_worker() const
+{
+    if (t_job_system == this)
+    {
+        return t_worker;
+    }
+    assert(std::this_thread::get_id() == m_owner);
+    return 0;
+}
+
+void JobSystem::run_worker(uint32_t worker)
+{
+    while (true)
+    {
+        bool found = false;
+        for (uint32_t i = 0; i < SPIN_COUNT && !found; ++i)
+        {
+            found = run_job(worker);
+        }
+        if (found)
+        {
+            continue;
+        }
+
+        std::unique_lock lock(m_sleep_mutex);
+        m_job_available.wait(lock, [this] {
+            return m_stopping || m_queued_jobs.load(std::memory_order_relaxed) > 0;
+        });
+        if (m_stopping && m_queued_jobs.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+    }
+}
+
+bool JobSystem::run_job(uint32_t worker)
+{
+    Job job;
+    bool found = false;
+    bool stolen = false;
+    {
+        Worker &own = *m_workers[worker];
+        std::lock_guard lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            found = true;
+        }
+    }
+
+    for (size_t i = 1; i < m_workers.size() && !found; ++i)
+    {
+        Worker &victim = *m_workers[(worker + i) % m_workers.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            found = true;
+            stolen = true;
+        }
+    }
+
+    if (!found)
+    {
+        return false;
+    }
+    m_queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+
+    auto start = std::chrono::steady_clock::now();
+    job.task->function(job.start, job.end, worker, job.task->context);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    Worker &stats = *m_workers[worker];
+    auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    stats.busy_ns.fetch_add(static_cast<uint64_t>(elapsed_ns), std::memory_order_relaxed);
+    stats.job_count.fetch_add(1, std::memory_order_relaxed);
+    if (stolen)
+    {
+        stats.steal_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    job.task->remaining_jobs.fetch_sub(1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+struct JobWorkerStats
+{
+    // time spent running jobs
+    uint64_t busy_ns;
+    uint64_t job_count;
+    // jobs taken from another worker's queue
+    uint64_t steal_count;
+};
+
+// Fork-join scheduler for short data-parallel work such as physics steps. A range of items is
+// split into jobs that are pushed onto the queue of the calling worker. Every worker runs the
+// newest jobs of its own queue first and steals the oldest ones of other queues when it runs dry.
+// The thread that creates the job system is worker 0 and helps running jobs while it waits, so
+// only it and the jobs themselves may enqueue and wait. Long blocking work belongs on the
+// `ThreadPool` instead.
+class JobSystem
+{
+  public:
+    // box2d supports at most 64 workers
+    static constexpr uint32_t MAX_WORKER_COUNT = 64;
+
+    // same shape as box2d's task callback, so physics tasks are run without an adapter
+    typedef void JobFunction(int32_t start, int32_t end, uint32_t worker, void *context);
+
+    struct Task
+    {
+        JobFunction *function;
+        void *context;
+        std::atomic<uint32_t> remaining_jobs;
+    };
+
+  private:
+    static constexpr uint32_t JOBS_PER_WORKER = 4;
+    // attempts to find a job before a worker goes to sleep, waking up costs more than a step's
+    // gap between two tasks
+    static constexpr uint32_t SPIN_COUNT = 256;
+
+    struct Job
+    {
+        Task *task;
+        int32_t start;
+        int32_t end;
+    };
+
+    struct alignas(64) Worker
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::atomic<uint64_t> busy_ns{0};
+        std::atomic<uint64_t> job_count{0};
+        std::atomic<uint64_t> steal_count{0};
+    };
+
+    std::thread::id m_owner;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_job_available;
+    std::atomic<uint32_t> m_queued_jobs{0};
+    bool m_stopping{false};
+
+    std::mutex m_task_mutex;
+    std::vector<std::unique_ptr<Task>> m_tasks;
+    std::vector<Task *> m_free_tasks;
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+    JobSystem(JobSystem &&) = delete;
+    JobSystem &operator=(JobSystem &&) = delete;
+
+  public:
+    // 0 uses one worker per hardware thread, including the calling thread
+    explicit JobSystem(uint32_t worker_count = 0);
+
+    ~JobSystem();
+
+    // Splits `count` items into ranges of at least `min_range` and queues them. Returns nothing if
+    // the range was small enough to be run right away on the calling thread, otherwise the task
+    // must be passed to `wait` exactly once.
+    [[nodiscard]] Task *enqueue(
+        int32_t count, int32_t min_range, JobFunction *function, void *context
+    );
+
+    // runs queued jobs until every job of `task` has finished, then recycles it
+    void wait(Task *task);
+
+    // Calls `function(start, end, worker)` over `count` items across all workers and returns once
+    // every item has been processed.
+    template<typename F>
+    void parallel_for(int32_t count, int32_t min_range, F &&function)
+    {
+        auto run = [](int32_t start, int32_t end, uint32_t worker, void *context) {
+            (*static_cast<std::remove_reference_t<F> *>(context))(start, end, worker);
+        };
+        wait(enqueue(count, min_range, run, &function));
+    }
+
+    [[nodiscard]] uint32_t get_worker_count() const
+    {
+        return static_cast<uint32_t>(m_workers.size());
+    }
+
+    [[nodiscard]] JobWorkerStats get_worker_stats(uint32_t worker) const;
+
+    void reset_stats();
+
+    // index of the worker running the calling thread, 0 on the thread that created the system
+    [[nodiscard]] uint32_t get_current_worker() const;
+
+  private:
+    void run_worker(uint32_t worker);
+
+    // runs one job of the worker's own queue, or a stolen one, returns false if there was none
+    bool run_job(uint32_t worker);
+};
@@ -0,0 +1,576 @@
+#include "level.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#include <spdlog/spdlog.h>
+
+#include "mapped_file.hpp"
+
+namespace
+{
+
+constexpr uint32_t MAX_LEVEL_SIDE = 16384;
+constexpr uint32_t MAX_LAYER_COUNT = 16;
+
+constexpr std::array<std::string_view, 2> SPAWN_TYPE_NAMES{"player", "coin"};
+
+// what a cell of a text layer turns into, tiles come first so they can be stored as is
+enum CellCode : uint8_t
+{
+    CELL_EMPTY = static_cast<uint8_t>(LevelTile::empty),
+    CELL_BLOCK = static_cast<uint8_t>(LevelTile::block),
+    CELL_PLAYER,
+    CELL_COIN,
+    CELL_INVALID,
+};
+
+constexpr std::array<uint8_t, 256> CELL_CODES = [] {
+    std::array<uint8_t, 256> codes{};
+    codes.fill(CELL_INVALID);
+    codes[' '] = CELL_EMPTY;
+    codes['.'] = CELL_EMPTY;
+    codes['#'] = CELL_BLOCK;
+    codes['P'] = CELL_PLAYER;
+    codes['C'] = CELL_COIN;
+    return codes;
+}();
+
+class LineReader
+{
+    std::string_view m_text;
+    size_t m_position{0};
+    uint32_t m_line_number{0};
+
+  public:
+    explicit LineReader(std::string_view text) : m_text(text)
+    {
+    }
+
+    [[nodiscard]] bool next(std::string_view &line)
+    {
+        if (m_position >= m_text.size())
+        {
+            return false;
+        }
+
+        size_t end = m_text.find('\n', m_position);
+        if (end == std::string_view::npos)
+        {
+            end = m_text.size();
+        }
+        line = m_text.substr(m_position, end - m_position);
+        if (line.ends_with('\r'))
+        {
+            line.remove_suffix(1);
+        }
+        m_position = end + 1;
+        ++m_line_number;
+        return true;
+    }
+
+    [[nodiscard]] uint32_t get_line_number() const
+    {
+        return m_line_number;
+    }
+};
+
+// splits the next word off `line`
+std::string_view next_token(std::string_view &line)
+{
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string_view::npos)
+    {
+        line = {};
+        return {};
+    }
+    size_t end = std::min(line.find_first_of(" \t", start), line.size());
+    std::string_view token = line.substr(start, end - start);
+    line.remove_prefix(end);
+    return token;
+}
+
+// Upper bounds of the layers and spawns of a text level, every `P` and `C` counts as a spawn even
+// outside of layer rows.
+struct TextLevelCounts
+{
+    size_t layer_count{0};
+    size_t spawn_count{0};
+};
+
+TextLevelCounts count_text_level(std::string_view text)
+{
+    TextLevelCounts counts;
+    LineReader reader(text);
+    std::string_view line;
+    while (reader.next(line))
+    {
+        counts.spawn_count += static_cast<size_t>(
+            std::count_if(line.begin(), line.end(), [](char c) { return c == 'P' || c == 'C'; })
+        );
+        std::string_view directive = next_token(line);
+        if (directive == "layer")
+        {
+            ++counts.layer_count;
+        }
+        else if (directive == "spawn")
+        {
+            ++counts.spawn_count;
+        }
+    }
+    return counts;
+}
+
+bool parse_u32(std::string_view token, uint32_t &value)
+{
+    auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+    return error == std::errc() && end == token.data() + token.size();
+}
+
+std::optional<LevelSpawnType> parse_spawn_type(std::string_view name)
+{
+    auto it = std::find(SPAWN_TYPE_NAMES.begin(), SPAWN_TYPE_NAMES.end(), name);
+    if (it == SPAWN_TYPE_NAMES.end())
+    {
+        return {};
+    }
+    return static_cast<LevelSpawnType>(it - SPAWN_TYPE_NAMES.begin());
+}
+
+bool is_valid_size(uint32_t width, uint32_t height)
+{
+    return width > 0 && height > 0 && width <= MAX_LEVEL_SIDE && height <= MAX_LEVEL_SIDE;
+}
+
+bool has_layer(const Level &level, std::string_view name)
+{
+    return std::any_of(level.layers.begin(), level.layers.end(), [&](const LevelLayer &layer) {
+        return layer.name == name;
+    });
+}
+
+bool find_solid_layer(Level &level, const char *caller)
+{
+    auto it = std::find_if(level.layers.begin(), level.layers.end(), [](const LevelLayer &layer) {
+        return layer.name == Level::SOLID_LAYER;
+    });
+    if (it == level.layers.end())
+    {
+        spdlog::error("{}: level has no `{}` layer", caller, Level::SOLID_LAYER);
+        return false;
+    }
+    level.solid_layer = static_cast<uint32_t>(it - level.layers.begin());
+    return true;
+}
+
+} // namespace
+
+std::optional<Level> parse_level(std::span<const uint8_t> data)
+{
+    if (data.size() >= LEVEL_MAGIC.size() &&
+        std::equal(LEVEL_MAGIC.begin(), LEVEL_MAGIC.end(), data.begin()))
+    {
+        return parse_level_binary(data);
+    }
+    return parse_level_text(
+        std::string_view(reinterpret_cast<const char *>(data.data()), data.size())
+    );
+}
+
+std::optional<Level> parse_level_text(std::string_view text)
+{
+    Level level;
+    bool has_header = false;
+
+    // a first pass sizes the layer and spawn arrays, so they are allocated once
+    TextLevelCounts counts = count_text_level(text);
+    level.layers.reserve(std::min(counts.layer_count, static_cast<size_t>(MAX_LAYER_COUNT)));
+    level.spawns.reserve(counts.spawn_count);
+
+    LineReader reader(text);
+    std::string_view line;
+    while (reader.next(line))
+    {
+        std::string_view directive = next_token(line);
+        if (directive.empty() || directive.starts_with(';'))
+        {
+            continue;
+        }
+
+        if (directive == "level")
+        {
+            if (has_header)
+            {
+                spdlog::error(
+                    "parse_level_text: line {}: repeated `level`",
+                    reader.get_line_number()
+                );
+                return {};
+            }
+            if (!parse_u32(next_token(line), level.width) ||
+                !parse_u32(next_token(line), level.height) ||
+                !is_valid_size(level.width, level.height) || !next_token(line).empty())
+            {
+                spdlog::error(
+                    "parse_level_text: line {}: expected `level <width> <height>` with sizes "
+                    "from 1 to {}",
+                    reader.get_line_number(),
+                    MAX_LEVEL_SIDE
+                );
+                return {};
+            }
+            has_header = true;
+        }
+        else if (!has_header)
+        {
+            spdlog::error(
+                "parse_level_text: line {}: expected `level` before `{}`",
+                reader.get_line_number(),
+                directive
+            );
+            return {};
+        }
+        else if (directive == "layer")
+        {
+            std::string_view name = next_token(line);
+            if (name.empty() || name.size() >= sizeof(LevelFileLayer::name) ||
+                !next_token(line).empty())
+            {
+                spdlog::error(
+                    "parse_level_text: line {}: expected `layer <name>` with a name shorter "
+                    "than {}",
+                    reader.get_line_number(),
+                    sizeof(LevelFileLayer::name)
+                );
+                return {};
+            }
+            if (has_layer(level, name) || level.layers.size() == MAX_LAYER_COUNT)
+            {
+                spdlog::error(
+                    "parse_level_text: line {}: layer `{}` is repeated or one of more than {}",
+                    reader.get_line_number(),
+                    name,
+                    MAX_LAYER_COUNT
+                );
+                return {};
+            }
+
+            LevelLayer &layer = level.layers.emplace_back(LevelLayer{
+                .name = std::string(name),
+                .tiles = std::vector<LevelTile>(static_cast<size_t>(level.width) * level.height),
+            });
+
+            for (uint32_t y = 0; y < level.height; ++y)
+            {
+                std::string_view row;
+                if (!reader.next(row) || row.size() > level.width)
+                {
+                    spdlog::error(
+                        "parse_level_text: line {}: layer `{}` needs {} rows of at most {} cells",
+                        reader.get_line_number(),
+                        name,
+                        level.height,
+                        level.width
+                    );
+                    return {};
+                }
+
+                LevelTile *tiles = layer.tiles.data() + static_cast<size_t>(y) * level.width;
+                for (uint32_t x = 0; x < row.size(); ++x)
+                {
+                    uint8_t code = CELL_CODES[static_cast<uint8_t>(row[x])];
+                    if (code <= CELL_BLOCK)
+                    {
+                        tiles[x] = static_cast<LevelTile>(code);
+                        continue;
+                    }
+                    if (code == CELL_INVALID)
+                    {
+                        spdlog::error(
+                            "parse_level_text: line {}: invalid cell `{}` at {}, {}",
+                            reader.get_line_number(),
+                            row[x],
+                            x,
+                            y
+                        );
+                        return {};
+                    }
+                    level.spawns.push_back(LevelSpawn{
+                        .type = code == CELL_PLAYER ? LevelSpawnType::player : LevelSpawnType::coin,
+                        .x = x,
+                        .y = y,
+                    });
+                }
+            }
+        }
+        else if (directive == "spawn")
+        {
+            std::optional<LevelSpawnType> type = parse_spawn_type(next_token(line));
+            LevelSpawn spawn{.type = type.value_or(LevelSpawnType::player), .x = 0, .y = 0};
+            if (!type || !parse_u32(next_token(line), spawn.x) ||
+                !parse_u32(next_token(line), spawn.y) || spawn.x >= level.width ||
+                spawn.y >= level.height || !next_token(line).empty())
+            {
+                spdlog::error(
+                    "parse_level_text: line {}: expected `spawn <player|coin> <x> <y>` inside the "
+                    "level",
+                    reader.get_line_number()
+                );
+                return {};
+            }
+            level.spawns.push_back(spawn);
+        }
+        else
+        {
+            spdlog::error(
+                "parse_level_text: line {}: unknown directive `{}`",
+                reader.get_line_number(),
+                directive
+            );
+            return {};
+        }
+    }
+
+    if (!has_header)
+    {
+        spdlog::error("parse_level_text: missing `level <width> <height>`");
+        return {};
+    }
+    if (!find_solid_layer(level, "parse_level_text"))
+    {
+        return {};
+    }
+    return level;
+}
+
+std::optional<Level> parse_level_binary(std::span<const uint8_t> data)
+{
+    LevelFileHeader header;
+    if (data.size() < sizeof(header))
+    {
+        spdlog::error("parse_level_binary: data is too small to be a level");
+        return {};
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (header.magic != LEVEL_MAGIC || header.version != LEVEL_VERSION)
+    {
+        spdlog::error("parse_level_binary: data is not a version {} level", LEVEL_VERSION);
+        return {};
+    }
+    if (!is_valid_size(header.width, header.height) || header.layer_count == 0 ||
+        header.layer_count > MAX_LAYER_COUNT)
+    {
+        spdlog::error(
+            "parse_level_binary: invalid size {}x{} or layer count {}",
+            header.width,
+            header.height,
+            header.layer_count
+        );
+        return {};
+    }
+
+    // the counts are bounded, so none of this can overflow
+    size_t tile_count = static_cast<size_t>(header.width) * header.height;
+    size_t spawns_offset = sizeof(header) + header.layer_count * sizeof(LevelFileLayer);
+    size_t tiles_offset = spawns_offset + static_cast<size_t>(header.spawn_count) *
+                                              sizeof(LevelFileSpawn);
+    if (data.size() != tiles_offset + header.layer_count * tile_count)
+    {
+        spdlog::error(
+            "parse_level_binary: size {} does not match the {} tiles and {} spawns of the header",
+            data.size(),
+            header.layer_count * tile_count,
+            header.spawn_count
+        );
+        return {};
+    }
+
+    Level level{
+        .width = header.width,
+        .height = header.height,
+        .layers = {},
+        .spawns = {},
+        .solid_layer = 0,
+    };
+
+    level.layers.reserve(header.layer_count);
+    for (uint32_t i = 0; i < header.layer_count; ++i)
+    {
+        LevelFileLayer file_layer;
+        const uint8_t *file_layer_data = data.data() + sizeof(header) + i * sizeof(file_layer);
+        std::memcpy(&file_layer, file_layer_data, sizeof(file_layer));
+        auto name_end = std::find(file_layer.name.begin(), file_layer.name.end(), '\0');
+        std::string_view name(file_layer.name.data(), name_end - file_layer.name.begin());
+        if (name_end == file_layer.name.end() || name.empty() || has_layer(level, name))
+        {
+            spdlog::error("parse_level_binary: layer {} has an invalid or repeated name", i);
+            return {};
+        }
+
+        const uint8_t *src = data.data() + tiles_offset + i * tile_count;
+        LevelLayer &layer = level.layers.emplace_back(LevelLayer{
+            .name = std::string(name),
+            .tiles = std::vector<LevelTile>(tile_count),
+        });
+        std::memcpy(layer.tiles.data(), src, tile_count);
+
+        // a max reduction vectorizes, unlike an early-out search for an invalid byte
+        uint8_t max_tile = 0;
+        for (size_t j = 0; j < tile_count; ++j)
+        {
+            max_tile = std::max(max_tile, src[j]);
+        }
+        if (max_tile > static_cast<uint8_t>(LevelTile::block))
+        {
+            spdlog::error("parse_level_binary: layer `{}` has an invalid tile {}", name, max_tile);
+            return {};
+        }
+    }
+
+    level.spawns.resize(header.spawn_count);
+    for (uint32_t i = 0; i < header.spawn_count; ++i)
+    {
+        LevelFileSpawn file_spawn;
+        const uint8_t *file_spawn_data = data.data() + spawns_offset + i * sizeof(file_spawn);
+        std::memcpy(&file_spawn, file_spawn_data, sizeof(file_spawn));
+        if (static_cast<size_t>(file_spawn.type) >= SPAWN_TYPE_NAMES.size() ||
+            file_spawn.x >= level.width || file_spawn.y >= level.height)
+        {
+            spdlog::error("parse_level_binary: spawn {} is invalid or outside the level", i);
+            return {};
+        }
+        level.spawns[i] = LevelSpawn{.type = file_spawn.type, .x = file_spawn.x, .y = file_spawn.y};
+    }
+
+    if (!find_solid_layer(level, "parse_level_binary"))
+    {
+        return {};
+    }
+    return level;
+}
+
+std::optional<Level> load_level_file(const std::string &path)
+{
+    MappedFile file;
+    if (!file.open(path))
+    {
+        return {};
+    }
+    return parse_level(file.get_data());
+}
+
+std::string write_level_text(const Level &level)
+{
+    std::string text;
+    text.reserve(
+        level.layers.size() * (static_cast<size_t>(level.width) + 1) * level.height +
+        level.spawns.size() * 24 + 64
+    );
+
+    text += "level " + std::to_string(level.width) + " " + std::to_string(level.height) + "\n";
+    for (const LevelLayer &layer : level.layers)
+    {
+        text += "layer " + layer.name + "\n";
+        for (uint32_t y = 0; y < level.height; ++y)
+        {
+            size_t row_start = text.size();
+            for (uint32_t x = 0; x < level.width; ++x)
+            {
+                bool block = layer.tiles[static_cast<size_t>(y) * level.width + x] ==
+                             LevelTile::block;
+                text += block ? '#' : ' ';
+            }
+            // rows are padded when parsed, so trailing empty tiles need not be written
+            size_t row_end = text.find_last_not_of(' ');
+            text.resize(row_end == std::string::npos || row_end < row_start ? row_start
+                                                                           : row_end + 1);
+            text += '\n';
+        }
+    }
+    for (const LevelSpawn &spawn : level.spawns)
+    {
+        text += "spawn ";
+        text += SPAWN_TYPE_NAMES[static_cast<size_t>(spawn.type)];
+        text += " " + std::to_string(spawn.x) + " " + std::to_string(spawn.y) + "\n";
+    }
+    return text;
+}
+
+std::vector<uint8_t> write_level_binary(const Level &level)
+{
+    LevelFileHeader header{
+        .magic = LEVEL_MAGIC,
+        .version = LEVEL_VERSION,
+        .width = level.width,
+        .height = level.height,
+        .layer_count = static_cast<uint32_t>(level.layers.size()),
+        .spawn_count = static_cast<uint32_t>(level.spawns.size()),
+    };
+
+    size_t tile_count = static_cast<size_t>(level.width) * level.height;
+    std::vector<uint8_t> data(
+        sizeof(header) + level.layers.size() * (sizeof(LevelFileLayer) + tile_count) +
+        level.spawns.size() * sizeof(LevelFileSpawn)
+    );
+    uint8_t *dst = data.data();
+    std::memcpy(dst, &header, sizeof(header));
+    dst += sizeof(header);
+
+    for (const LevelLayer &layer : level.layers)
+    {
+        LevelFileLayer file_layer{};
+        std::copy_n(
+            layer.name.begin(),
+            std::min(layer.name.size(), file_layer.name.size() - 1),
+            file_layer.name.begin()
+        );
+        std::memcpy(dst, &file_layer, sizeof(file_layer));
+        dst += sizeof(file_layer);
+    }
+    for (const LevelSpawn &spawn : level.spawns)
+    {
+        LevelFileSpawn file_spawn{.x = spawn.x, .y = spawn.y, .type = spawn.type, .reserved = {}};
+        std::memcpy(dst, &file_spawn, sizeof(file_spawn));
+        dst += sizeof(file_spawn);
+    }
+    for (const LevelLayer &layer : level.layers)
+    {
+        std::memcpy(dst, layer.tiles.data(), tile_count);
+        dst += tile_count;
+    }
+    return data;
+}
+
+bool validate_level(const Level &level)
+{
+    bool valid = true;
+
+    auto player_count = std::count_if(level.spawns.begin(), level.spawns.end(), [](const auto &s) {
+        return s.type == LevelSpawnType::player;
+    });
+    if (player_count != 1)
+    {
+        spdlog::error("validate_level: level has {} player spawns instead of 1", player_count);
+        valid = false;
+    }
+
+    for (size_t i = 0; i < level.spawns.size(); ++i)
+    {
+        const LevelSpawn &spawn = level.spawns[i];
+        if (level.get_solid_tile(spawn.x, spawn.y) != LevelTile::empty)
+        {
+            spdlog::error(
+                "validate_level: {} spawn {} at {}, {} is inside a solid tile",
+                SPAWN_TYPE_NAMES[static_cast<size_t>(spawn.type)],
+                i,
+                spawn.x,
+                spawn.y
+            );
+            valid = false;
+        }
+    }
+
+    return valid;
+}
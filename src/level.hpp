@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class LevelTile : uint8_t
+{
+    empty,
+    block,
+};
+
+enum class LevelSpawnType : uint8_t
+{
+    player,
+    coin,
+};
+
+struct LevelSpawn
+{
+    LevelSpawnType type;
+    uint32_t x;
+    uint32_t y;
+};
+
+struct LevelLayer
+{
+    std::string name;
+    std::vector<LevelTile> tiles;
+};
+
+// The tile layers of a level and the entities it spawns, in tile coordinates with rows counted
+// from the top like `Tilemap`. Tiles of every layer are drawn, only the `solid` layer collides.
+struct Level
+{
+    static constexpr std::string_view SOLID_LAYER = "solid";
+
+    uint32_t width{0};
+    uint32_t height{0};
+    std::vector<LevelLayer> layers;
+    std::vector<LevelSpawn> spawns;
+    // index of the layer named `SOLID_LAYER`
+    uint32_t solid_layer{0};
+
+    [[nodiscard]] LevelTile get_tile(uint32_t layer, uint32_t x, uint32_t y) const
+    {
+        return layers[layer].tiles[static_cast<size_t>(y) * width + x];
+    }
+
+    [[nodiscard]] LevelTile get_solid_tile(uint32_t x, uint32_t y) const
+    {
+        return get_tile(solid_layer, x, y);
+    }
+};
+
+// Layout of a binary level file: a `LevelFileHeader`, `layer_count` `LevelFileLayer`s,
+// `spawn_count` `LevelFileSpawn`s and then `width * height` tile bytes per layer, in the order of
+// the layer table. All integers are little endian.
+static constexpr std::array<char, 4> LEVEL_MAGIC{'P', 'F', 'L', 'V'};
+static constexpr uint32_t LEVEL_VERSION = 1;
+
+struct LevelFileHeader
+{
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t layer_count;
+    uint32_t spawn_count;
+};
+
+struct LevelFileLayer
+{
+    // nul terminated
+    std::array<char, 32> name;
+};
+
+struct LevelFileSpawn
+{
+    uint32_t x;
+    uint32_t y;
+    LevelSpawnType type;
+    std::array<uint8_t, 3> reserved;
+};
+static_assert(sizeof(LevelFileHeader) == 24);
+static_assert(sizeof(LevelFileLayer) == 32);
+static_assert(sizeof(LevelFileSpawn) == 12);
+
+// Parses a level in either format, telling them apart by `LEVEL_MAGIC`. Nothing is allocated
+// besides the level's own arrays, each sized once, from the header of a binary level or from a
+// first pass over a text level. Logs and returns nothing if the data is malformed.
+[[nodiscard]] std::optional<Level> parse_level(std::span<const uint8_t> data);
+
+// Text levels are made of lines of the form:
+//
+//   ; comment
+//   level <width> <height>
+//   layer <name>
+//   <height rows of `#` (block), ` ` or `.` (empty), `P` (player) or `C` (coin)>
+//   spawn <player|coin> <x> <y>
+//
+// `level` comes first. Rows shorter than the level are padded with empty tiles, so editors that
+// strip trailing spaces do not break a level. `P` and `C` leave an empty tile and add a spawn.
+[[nodiscard]] std::optional<Level> parse_level_text(std::string_view text);
+
+[[nodiscard]] std::optional<Level> parse_level_binary(std::span<const uint8_t> data);
+
+// memory-maps and parses `path`, in either format
+[[nodiscard]] std::optional<Level> load_level_file(const std::string &path);
+
+[[nodiscard]] std::string write_level_text(const Level &level);
+
+[[nodiscard]] std::vector<uint8_t> write_level_binary(const Level &level);
+
+// Checks what the game relies on beyond a well-formed file: a single player spawn, and spawns
+// that are not inside a solid tile. Logs every problem found and returns whether there were none.
+[[nodiscard]] bool validate_level(const Level &level);
@@ -0,0 +1,189 @@
+#include "level_streamer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "profiler.hpp"
+
+LevelStreamer::LevelStreamer(
+    const Level *level, ThreadPool *thread_pool, float tile_size, const glm::vec2 &origin,
+    float load_margin, float unload_margin
+)
+    : m_level(level), m_thread_pool(thread_pool), m_tile_size(tile_size), m_origin(origin),
+      m_load_margin(load_margin), m_unload_margin(std::max(load_margin, unload_margin)),
+      m_region_columns((level->width + REGION_SIZE - 1) / REGION_SIZE),
+      m_region_rows((level->height + REGION_SIZE - 1) / REGION_SIZE),
+      m_states(static_cast<size_t>(m_region_columns) * m_region_rows, RegionState::unloaded)
+{
+    // counting sort of the spawns by region
+    m_region_spawn_offsets.resize(m_states.size() + 1, 0);
+    auto get_spawn_region = [&](const LevelSpawn &spawn) {
+        return (spawn.y / REGION_SIZE) * m_region_columns + spawn.x / REGION_SIZE;
+    };
+    for (const auto &spawn : m_level->spawns)
+    {
+        ++m_region_spawn_offsets[get_spawn_region(spawn) + 1];
+    }
+    for (size_t region = 0; region < m_states.size(); ++region)
+    {
+        m_region_spawn_offsets[region + 1] += m_region_spawn_offsets[region];
+    }
+
+    std::vector<uint32_t> next = m_region_spawn_offsets;
+    m_region_spawns.resize(m_level->spawns.size());
+    for (uint32_t spawn_idx = 0; spawn_idx < m_level->spawns.size(); ++spawn_idx)
+    {
+        m_region_spawns[next[get_spawn_region(m_level->spawns[spawn_idx])]++] = spawn_idx;
+    }
+}
+
+LevelStreamer::~LevelStreamer()
+{
+    for (auto &[region, future] : m_pending_regions)
+    {
+        future.wait();
+    }
+}
+
+void LevelStreamer::update(
+    const Aabb &view, bool wait, std::vector<LevelRegionData> &loaded,
+    std::vector<uint32_t> &unloaded
+)
+{
+    PROFILE_ZONE("LevelStreamer::update");
+    RegionRange load_range = get_region_range(view, m_load_margin);
+    RegionRange keep_range = get_region_range(view, m_unload_margin);
+    auto is_kept = [&](uint32_t region) {
+        return keep_range.contains(region % m_region_columns, region / m_region_columns);
+    };
+
+    for (size_t i = 0; i < m_loaded_regions.size();)
+    {
+        uint32_t region = m_loaded_regions[i];
+        if (is_kept(region))
+        {
+            ++i;
+            continue;
+        }
+        m_states[region] = RegionState::unloaded;
+        unloaded.push_back(region);
+        m_loaded_regions[i] = m_loaded_regions.back();
+        m_loaded_regions.pop_back();
+    }
+
+    for (uint32_t y = load_range.first_y; y < load_range.last_y; ++y)
+    {
+        for (uint32_t x = load_range.first_x; x < load_range.last_x; ++x)
+        {
+            uint32_t region = y * m_region_columns + x;
+            if (m_states[region] == RegionState::unloaded)
+            {
+                m_states[region] = RegionState::loading;
+                m_pending_regions.emplace_back(
+                    region,
+                    m_thread_pool->submit([this, region] { return build_region(region); })
+                );
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m_pending_regions.size();)
+    {
+        auto &[region, future] = m_pending_regions[i];
+        bool needed_now = wait && load_range.contains(
+                                      region % m_region_columns,
+                                      region / m_region_columns
+                                  );
+        if (!needed_now && future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++i;
+            continue;
+        }
+
+        // a region that left the view while it was loading is dropped and loaded again later
+        LevelRegionData data = future.get();
+        if (is_kept(region))
+        {
+            m_states[region] = RegionState::loaded;
+            m_loaded_regions.push_back(region);
+            loaded.push_back(std::move(data));
+        }
+        else
+        {
+            m_states[region] = RegionState::unloaded;
+        }
+        m_pending_regions[i] = std::move(m_pending_regions.back());
+        m_pending_regions.pop_back();
+    }
+}
+
+TileRect LevelStreamer::get_region_tiles(uint32_t region) const
+{
+    uint32_t x = (region % m_region_columns) * REGION_SIZE;
+    uint32_t y = (region / m_region_columns) * REGION_SIZE;
+    return TileRect{
+        .x = x,
+        .y = y,
+        .width = std::min(REGION_SIZE, m_level->width - x),
+        .height = std::min(REGION_SIZE, m_level->height - y),
+    };
+}
+
+LevelStreamer::RegionRange LevelStreamer::get_region_range(const Aabb &bounds, float margin) const
+{
+    // tile columns grow with x, tile rows grow downwards from the top of the level
+    float level_top = m_origin.y + static_cast<float>(m_level->height) * m_tile_size;
+    float first_column = std::floor((bounds.min.x - margin - m_origin.x) / m_tile_size);
+    float last_column = std::floor((bounds.max.x + margin - m_origin.x) / m_tile_size);
+    float first_row = std::floor((level_top - (bounds.max.y + margin)) / m_tile_size);
+    float last_row = std::floor((level_top - (bounds.min.y - margin)) / m_tile_size);
+
+    if (last_column < 0.0f || last_row < 0.0f ||
+        first_column >= static_cast<float>(m_level->width) ||
+        first_row >= static_cast<float>(m_level->height))
+    {
+        return RegionRange{.first_x = 0, .first_y = 0, .last_x = 0, .last_y = 0};
+    }
+
+    auto to_region = [](float tile, uint32_t tile_count) {
+        return static_cast<uint32_t>(std::clamp(tile, 0.0f, static_cast<float>(tile_count - 1))) /
+               REGION_SIZE;
+    };
+    return RegionRange{
+        .first_x = to_region(first_column, m_level->width),
+        .first_y = to_region(first_row, m_level->height),
+        .last_x = to_region(last_column, m_level->width) + 1,
+        .last_y = to_region(last_row, m_level->height) + 1,
+    };
+}
+
+LevelRegionData LevelStreamer::build_region(uint32_t region) const
+{
+    PROFILE_ZONE("LevelStreamer::build_region");
+    TileRect tiles = get_region_tiles(region);
+
+    std::vector<uint8_t> solid(static_cast<size_t>(tiles.width) * tiles.height);
+    for (uint32_t y = 0; y < tiles.height; ++y)
+    {
+        for (uint32_t x = 0; x < tiles.width; ++x)
+        {
+            solid[static_cast<size_t>(y) * tiles.width + x] =
+                m_level->get_solid_tile(tiles.x + x, tiles.y + y) != LevelTile::empty;
+        }
+    }
+
+    LevelRegionData data{
+        .region = region,
+        .solid_rects = merge_solid_tiles(tiles.width, tiles.height, solid),
+        .spawns = std::vector<uint32_t>(
+            m_region_spawns.begin() + m_region_spawn_offsets[region],
+            m_region_spawns.begin() + m_region_spawn_offsets[region + 1]
+        ),
+    };
+    for (auto &rect : data.solid_rects)
+    {
+        rect.x += tiles.x;
+        rect.y += tiles.y;
+    }
+    return data;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "aabb.hpp"
+#include "level.hpp"
+#include "thread_pool.hpp"
+#include "tilemap.hpp"
+#include "tilemap_collision.hpp"
+
+// Everything a region needs to be added to the world, built on a worker thread.
+struct LevelRegionData
+{
+    uint32_t region;
+    // solid tiles merged into rectangles, in level tile coordinates
+    std::vector<TileRect> solid_rects;
+    // indices into `Level::spawns` of the spawns inside the region
+    std::vector<uint32_t> spawns;
+};
+
+// Splits a level into square regions and decides which of them should be in the world for a
+// given view. Regions start loading on the thread pool once they come within `load_margin` of
+// the view and are unloaded once they are farther than `unload_margin`. Keeping the unload margin
+// larger than the load margin stops a region from being loaded and unloaded again every time
+// the view moves back and forth across its edge. Only regions near the view are ever tracked
+// individually, so the cost of an update does not depend on the size of the level.
+class LevelStreamer
+{
+  public:
+    // a whole number of tilemap chunks, so a region never shares a chunk with its neighbours
+    static constexpr uint32_t REGION_SIZE = 2 * Tilemap::CHUNK_SIZE;
+
+  private:
+    enum class RegionState : uint8_t
+    {
+        unloaded,
+        loading,
+        loaded,
+    };
+
+    struct RegionRange
+    {
+        uint32_t first_x;
+        uint32_t first_y;
+        uint32_t last_x;
+        uint32_t last_y;
+
+        [[nodiscard]] bool contains(uint32_t x, uint32_t y) const
+        {
+            return x >= first_x && x < last_x && y >= first_y && y < last_y;
+        }
+    };
+
+    const Level *m_level;
+    ThreadPool *m_thread_pool;
+    float m_tile_size;
+    glm::vec2 m_origin;
+    float m_load_margin;
+    float m_unload_margin;
+
+    uint32_t m_region_columns;
+    uint32_t m_region_rows;
+    std::vector<RegionState> m_states;
+    // spawn indices bucketed by region, the spawns of region `r` are
+    // `m_region_spawns[m_region_spawn_offsets[r]..m_region_spawn_offsets[r + 1]]`
+    std::vector<uint32_t> m_region_spawn_offsets;
+    std::vector<uint32_t> m_region_spawns;
+
+    std::vector<uint32_t> m_loaded_regions;
+    std::vector<std::pair<uint32_t, std::future<LevelRegionData>>> m_pending_regions;
+
+    LevelStreamer(const LevelStreamer &) = delete;
+    LevelStreamer &operator=(const LevelStreamer &) = delete;
+    LevelStreamer(LevelStreamer &&) = delete;
+    LevelStreamer &operator=(LevelStreamer &&) = delete;
+
+  public:
+    // `origin` is the world position of the bottom-left corner of the level
+    LevelStreamer(
+        const Level *level, ThreadPool *thread_pool, float tile_size, const glm::vec2 &origin,
+        float load_margin, float unload_margin
+    );
+
+    // waits for regions that are still loading, which read from the level
+    ~LevelStreamer();
+
+    // Appends regions that finished loading and are still wanted to `loaded` and regions that
+    // should be removed from the world to `unloaded`, then starts loading regions near `view`.
+    // With `wait` it also waits for every region near `view` to finish loading.
+    void update(
+        const Aabb &view, bool wait, std::vector<LevelRegionData> &loaded,
+        std::vector<uint32_t> &unloaded
+    );
+
+    // the tiles of a region, clipped to the level
+    [[nodiscard]] TileRect get_region_tiles(uint32_t region) const;
+
+    [[nodiscard]] size_t get_region_count() const
+    {
+        return m_states.size();
+    }
+
+    [[nodiscard]] size_t get_loaded_region_count() const
+    {
+        return m_loaded_regions.size();
+    }
+
+    [[nodiscard]] size_t get_loading_region_count() const
+    {
+        return m_pending_regions.size();
+    }
+
+  private:
+    // regions overlapping `bounds` grown by `margin` on every side, empty if none do
+    [[nodiscard]] RegionRange get_region_range(const Aabb &bounds, float margin) const;
+
+    [[nodiscard]] LevelRegionData build_region(uint32_t region) const;
+};
@@ -0,0 +1,106 @@
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "level.hpp"
+
+// Offline tool that checks level files and converts them between the text format used for
+// authoring and the binary format shipped in the asset pack, see `level.hpp`. Outputs ending in
+// `.lvl` are written as binary, anything else as text.
+
+static bool ends_with(std::string_view str, std::string_view suffix)
+{
+    return str.size() >= suffix.size() && str.substr(str.size() - suffix.size()) == suffix;
+}
+
+static std::optional<Level> load_and_validate(const std::string &path)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::optional<Level> level = load_level_file(path);
+    double elapsed_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    if (!level || !validate_level(*level))
+    {
+        spdlog::error("load_and_validate: {} is not a valid level", path);
+        return {};
+    }
+
+    spdlog::info(
+        "load_and_validate: {}: {}x{}, {} layers, {} spawns, parsed in {:.3f}ms",
+        path,
+        level->width,
+        level->height,
+        level->layers.size(),
+        level->spawns.size(),
+        elapsed_ms
+    );
+    return level;
+}
+
+static bool write_level(const std::string &path, const Level &level)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open())
+    {
+        spdlog::error("write_level: failed to open {}", path);
+        return false;
+    }
+
+    if (ends_with(path, ".lvl"))
+    {
+        std::vector<uint8_t> data = write_level_binary(level);
+        out.write(
+            reinterpret_cast<const char *>(data.data()),
+            static_cast<std::streamsize>(data.size())
+        );
+    }
+    else
+    {
+        std::string text = write_level_text(level);
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    if (!out.good())
+    {
+        spdlog::error("write_level: failed to write {}", path);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    std::string_view command = argc >= 2 ? argv[1] : "";
+    if (command == "validate" && argc >= 3)
+    {
+        bool valid = true;
+        for (int i = 2; i < argc; ++i)
+        {
+            valid = load_and_validate(argv[i]).has_value() && valid;
+        }
+        return valid ? 0 : 1;
+    }
+
+    if (command == "convert" && argc == 4)
+    {
+        std::optional<Level> level = load_and_validate(argv[2]);
+        if (!level || !write_level(argv[3], *level))
+        {
+            return 1;
+        }
+        spdlog::info("main: wrote {}", argv[3]);
+        return 0;
+    }
+
+    spdlog::error(
+        "main: usage: {0} validate <level>... | {0} convert <input> <output[.lvl]>",
+        argc >= 1 ? argv[0] : "level_tool"
+    );
+    return 1;
+}
@@ -1,14 +1,84 @@
+#include <algorithm>
 #include <array>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
 
 #include <SDL3/SDL.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include "bench.hpp"
 #include "engine.hpp"
+#include "profiler.hpp"
 
-int main()
+static bool parse_present_mode(std::string_view name, PresentMode &mode)
 {
+    for (PresentMode candidate : {PresentMode::vsync, PresentMode::mailbox, PresentMode::immediate})
+    {
+        if (name == get_present_mode_name(candidate))
+        {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    std::optional<uint64_t> headless_frames;
+    std::optional<std::string> profile_trace_path;
+    std::optional<std::string_view> benchmark_name;
+    size_t benchmark_size = 0;
+    FrameSettings frame_settings;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg == "--headless" && i + 1 < argc)
+        {
+            headless_frames = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--profile" && i + 1 < argc)
+        {
+            profile_trace_path = argv[++i];
+        }
+        else if (arg == "--bench" && i + 1 < argc)
+        {
+            benchmark_name = argv[++i];
+        }
+        else if (arg == "--bench-size" && i + 1 < argc)
+        {
+            benchmark_size = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--present-mode" && i + 1 < argc &&
+                 parse_present_mode(argv[i + 1], frame_settings.present_mode))
+        {
+            ++i;
+        }
+        else if (arg == "--fps" && i + 1 < argc)
+        {
+            frame_settings.target_rate = std::max(std::strtod(argv[++i], nullptr), 0.0);
+        }
+        else if (arg == "--frames-in-flight" && i + 1 < argc)
+        {
+            frame_settings.frames_in_flight =
+                std::clamp<uint32_t>(std::strtoul(argv[++i], nullptr, 10), 1, 3);
+        }
+        else
+        {
+            spdlog::error(
+                "main: usage: {} [--headless <frames>] [--profile <trace.json>] [--bench <name> "
+                "[--bench-size <n>]] [--present-mode <vsync|mailbox|immediate>] [--fps <rate>] "
+                "[--frames-in-flight <1-3>]",
+                argv[0]
+            );
+            return 1;
+        }
+    }
+
     std::array<spdlog::sink_ptr, 2> sinks{
         std::make_shared<spdlog::sinks::stdout_sink_st>(),
         std::make_shared<spdlog::sinks::basic_file_sink_st>("platformer-log.txt"),
@@ -19,29 +89,52 @@ int main()
     spdlog::set_default_logger(combined_logger);
     spdlog::set_level(spdlog::level::trace);
 
+    if (benchmark_name)
+    {
+        return run_benchmark(*benchmark_name, benchmark_size) ? 0 : 1;
+    }
+
     SDL_SetAppMetadata("Platformer", "0.1", nullptr);
     spdlog::trace("main: set sdl app metadata");
 
-    if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO))
+    if (profile_trace_path)
+    {
+        Profiler::set_enabled(true, true);
+        spdlog::trace("main: enabled profiler");
+    }
+
+    SDL_InitFlags init_flags = headless_frames ? 0 : SDL_INIT_VIDEO | SDL_INIT_AUDIO;
+    if (!SDL_Init(init_flags))
     {
         spdlog::error("main: failed to initialize sdl: {}", SDL_GetError());
         return 1;
     }
-    spdlog::trace("main: initialized sdl video and audio subsystem");
+    spdlog::trace("main: initialized sdl");
 
-    SDL_Window *window = SDL_CreateWindow("Platformer", WIDTH, HEIGHT, 0);
-    if (!window)
+    SDL_Window *window = nullptr;
+    if (!headless_frames)
     {
-        spdlog::error("main: failed to create window and renderer: {}", SDL_GetError());
-        return 1;
+        window = SDL_CreateWindow("Platformer", WIDTH, HEIGHT, 0);
+        if (!window)
+        {
+            spdlog::error("main: failed to create window and renderer: {}", SDL_GetError());
+            return 1;
+        }
+        spdlog::trace("main: created sdl window");
     }
-    spdlog::trace("main: created sdl window");
 
     {
-        Engine engine(window);
+        Engine engine(window, frame_settings);
         if (engine.init())
         {
-            engine.run();
+            if (headless_frames)
+            {
+                engine.run_headless(*headless_frames, 1.0 / 60.0);
+            }
+            else
+            {
+                engine.run();
+            }
         }
         else
         {
@@ -49,7 +142,19 @@ int main()
         }
     }
 
-    SDL_DestroyWindow(window);
+    if (window)
+    {
+        SDL_DestroyWindow(window);
+    }
+
+    if (profile_trace_path)
+    {
+        Profiler::log_summary();
+        if (!Profiler::export_chrome_trace(*profile_trace_path))
+        {
+            spdlog::error("main: failed to export profiler trace");
+        }
+    }
 
     spdlog::trace("main: process terminating...");
     return 0;
@@ -0,0 +1,136 @@
+#include "mapped_file.hpp"
+
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+
+    HANDLE file = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        spdlog::error("MappedFile::open: failed to open file {}", path);
+        return false;
+    }
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        spdlog::error("MappedFile::open: file {} is empty or its size is unknown", path);
+        close();
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        spdlog::error("MappedFile::open: failed to create file mapping for {}", path);
+        close();
+        return false;
+    }
+    m_mapping = mapping;
+
+    void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        spdlog::error("MappedFile::open: failed to map {}", path);
+        close();
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t *>(data);
+    m_size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr)
+    {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != nullptr)
+    {
+        CloseHandle(m_file);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_file = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    if (m_fd < 0)
+    {
+        spdlog::error("MappedFile::open: failed to open file {}", path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(m_fd, &st) != 0 || st.st_size == 0)
+    {
+        spdlog::error("MappedFile::open: file {} is empty or its size is unknown", path);
+        close();
+        return false;
+    }
+
+    void *data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (data == MAP_FAILED)
+    {
+        spdlog::error("MappedFile::open: failed to map {}", path);
+        close();
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t *>(data);
+    m_size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<uint8_t *>(m_data), m_size);
+    }
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_fd = -1;
+}
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// Read-only memory mapping of a whole file.
+class MappedFile
+{
+#ifdef _WIN32
+    void *m_file{nullptr};
+    void *m_mapping{nullptr};
+#else
+    int m_fd{-1};
+#endif
+    const uint8_t *m_data{nullptr};
+    size_t m_size{0};
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+
+  public:
+    MappedFile() = default;
+
+    ~MappedFile()
+    {
+        close();
+    }
+
+    [[nodiscard]] bool open(const std::string &path);
+
+    void close();
+
+    [[nodiscard]] bool is_open() const
+    {
+        return m_data != nullptr;
+    }
+
+    [[nodiscard]] std::span<const uint8_t> get_data() const
+    {
+        return {m_data, m_size};
+    }
+};
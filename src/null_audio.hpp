@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+
+#include "audio.hpp"
+#include "slot_map.hpp"
+
+// Audio backend that loads and plays nothing, used when running without an audio device.
+class NullAudio final : public Audio
+{
+    SlotMap<char> m_sources;
+    SlotMap<char> m_streams;
+    std::atomic<AudioVoiceId> m_next_voice{1};
+
+  public:
+    [[nodiscard]] std::optional<AudioSourceId> new_source(WavData) override
+    {
+        return m_sources.insert(0);
+    }
+
+    void free_source(AudioSourceId id) override
+    {
+        m_sources.erase(id);
+    }
+
+    AudioVoiceId play(AudioSourceId, float = 1.0f, float = 0.0f, float = 1.0f) override
+    {
+        return m_next_voice.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void stop(AudioVoiceId) override
+    {
+    }
+
+    void set_voice_params(AudioVoiceId, float, float) override
+    {
+    }
+
+    void set_voice_pitch(AudioVoiceId, float) override
+    {
+    }
+
+    [[nodiscard]] std::optional<AudioStreamId> new_stream(const std::string &, bool) override
+    {
+        return m_streams.insert(0);
+    }
+
+    void play_stream(AudioStreamId, float = 1.0f, float = 0.0f) override
+    {
+    }
+
+    void stop_stream(AudioStreamId) override
+    {
+    }
+
+    void free_stream(AudioStreamId id) override
+    {
+        m_streams.erase(id);
+    }
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "renderer.hpp"
+#include "slot_map.hpp"
+
+// Renderer that draws nothing and loads nothing, used when running without a GPU.
+class NullRenderer final : public Renderer
+{
+    SlotMap<char> m_textures;
+
+  public:
+    void render(const entt::registry &) override
+    {
+    }
+
+    void set_camera(const Camera &) override
+    {
+    }
+
+    bool set_present_mode(PresentMode) override
+    {
+        return true;
+    }
+
+    bool set_frames_in_flight(uint32_t) override
+    {
+        return true;
+    }
+
+    void set_tilemap(Tilemap *) override
+    {
+    }
+
+    [[nodiscard]] std::vector<TextureId> new_textures(std::span<const ImageData> images) override
+    {
+        std::vector<TextureId> ids(images.size());
+        for (auto &id : ids)
+        {
+            id = m_textures.insert(0);
+        }
+        return ids;
+    }
+
+    void free_textures(std::span<const TextureId> ids) override
+    {
+        for (TextureId id : ids)
+        {
+            m_textures.erase(id);
+        }
+    }
+};
@@ -5,10 +5,53 @@
 #include <box2d/types.h>
 
 #include "ecs.hpp"
+#include "job_system.hpp"
+#include "profiler.hpp"
 
-Physics::Physics()
+static void *entity_to_user_data(entt::entity entity)
+{
+    return reinterpret_cast<void *>(static_cast<uintptr_t>(entt::to_integral(entity)));
+}
+
+static entt::entity entity_from_user_data(void *user_data)
+{
+    return static_cast<entt::entity>(reinterpret_cast<uintptr_t>(user_data));
+}
+
+static entt::entity entity_from_shape(b2ShapeId shape_id)
+{
+    if (!b2Shape_IsValid(shape_id))
+    {
+        return entt::null;
+    }
+    return entity_from_user_data(b2Shape_GetUserData(shape_id));
+}
+
+static void *enqueue_task(
+    b2TaskCallback *task, int32_t item_count, int32_t min_range, void *task_context,
+    void *user_context
+)
+{
+    auto *job_system = static_cast<JobSystem *>(user_context);
+    // a null task tells box2d that the work already ran inline
+    return job_system->enqueue(item_count, min_range, task, task_context);
+}
+
+static void finish_task(void *user_task, void *user_context)
+{
+    static_cast<JobSystem *>(user_context)->wait(static_cast<JobSystem::Task *>(user_task));
+}
+
+Physics::Physics(JobSystem *job_system)
 {
     b2WorldDef world_def = b2DefaultWorldDef();
+    if (job_system != nullptr)
+    {
+        world_def.workerCount = static_cast<int32_t>(job_system->get_worker_count());
+        world_def.enqueueTask = enqueue_task;
+        world_def.finishTask = finish_task;
+        world_def.userTaskContext = job_system;
+    }
     world_def.gravity.y = -10.0f;
     world_def.maximumLinearVelocity = 1'000'000.0f;
     world_def.restitutionThreshold = world_def.maximumLinearVelocity;
@@ -21,10 +64,9 @@ Physics::~Physics()
     b2DestroyWorld(m_world_id);
 }
 
-void Physics::add(const Transform &transform, Collider &collider)
+static b2BodyDef make_body_def(const Collider &collider)
 {
     b2BodyDef body_def = b2DefaultBodyDef();
-    body_def.position = b2Vec2{transform.position.x, transform.position.y};
     body_def.linearVelocity = b2Vec2{collider.velocity.x, collider.velocity.y};
     body_def.type = [&]() {
         switch (collider.type)
@@ -35,11 +77,20 @@ void Physics::add(const Transform &transform, Collider &collider)
                 return b2_dynamicBody;
         }
     }();
-    body_def.gravityScale = collider.gravity ? 1.0f : 0.0f;
-    b2BodyId body_id = b2CreateBody(m_world_id, &body_def);
+    body_def.gravityScale = collider.gravity_scale;
+    return body_def;
+}
 
+static b2ShapeDef make_shape_def(const Collider &collider)
+{
     b2ShapeDef shape_def = b2DefaultShapeDef();
     shape_def.density = 1'000.0f;
+    shape_def.isSensor = collider.overlap_only;
+    return shape_def;
+}
+
+static void create_shape(b2BodyId body_id, const b2ShapeDef &shape_def, const Collider &collider)
+{
     switch (collider.shape.type)
     {
         case Collider::Shape::Type::rectangle: {
@@ -56,19 +107,144 @@ void Physics::add(const Transform &transform, Collider &collider)
             break;
         }
     }
-    shape_def.isSensor = collider.overlap_only;
+}
+
+void Physics::add(entt::entity entity, const Transform &transform, Collider &collider)
+{
+    b2BodyDef body_def = make_body_def(collider);
+    body_def.position = b2Vec2{transform.position.x, transform.position.y};
+    body_def.userData = entity_to_user_data(entity);
+    b2BodyId body_id = b2CreateBody(m_world_id, &body_def);
+
+    b2ShapeDef shape_def = make_shape_def(collider);
+    shape_def.userData = entity_to_user_data(entity);
+    create_shape(body_id, shape_def, collider);
 
     collider.id = body_id;
 }
 
+void Physics::add_bodies(
+    std::span<const entt::entity> entities, std::span<const glm::vec2> positions,
+    const Collider &collider, std::span<PhysicsBodyId> body_ids
+)
+{
+    PROFILE_ZONE("Physics::add_bodies");
+    b2BodyDef body_def = make_body_def(collider);
+    b2ShapeDef shape_def = make_shape_def(collider);
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        body_def.position = b2Vec2{positions[i].x, positions[i].y};
+        body_def.userData = entity_to_user_data(entities[i]);
+        shape_def.userData = body_def.userData;
+        body_ids[i] = b2CreateBody(m_world_id, &body_def);
+        create_shape(body_ids[i], shape_def, collider);
+    }
+}
+
 void Physics::remove(const Collider &collider)
 {
     b2DestroyBody(*collider.id);
 }
 
+PhysicsBodyId Physics::add_static_boxes(std::span<const PhysicsBox> boxes)
+{
+    b2BodyDef body_def = b2DefaultBodyDef();
+    body_def.type = b2_staticBody;
+    body_def.userData = entity_to_user_data(entt::null);
+    b2BodyId body_id = b2CreateBody(m_world_id, &body_def);
+
+    b2ShapeDef shape_def = b2DefaultShapeDef();
+    shape_def.density = 1'000.0f;
+    shape_def.userData = entity_to_user_data(entt::null);
+    for (const auto &box : boxes)
+    {
+        b2Polygon polygon = b2MakeOffsetBox(
+            box.size.x / 2.0f,
+            box.size.y / 2.0f,
+            b2Vec2{box.center.x, box.center.y},
+            0.0f
+        );
+        b2CreatePolygonShape(body_id, &shape_def, &polygon);
+    }
+
+    return body_id;
+}
+
+void Physics::remove_body(PhysicsBodyId body_id)
+{
+    b2DestroyBody(body_id);
+}
+
+void Physics::remove_bodies(std::span<const PhysicsBodyId> body_ids)
+{
+    PROFILE_ZONE("Physics::remove_bodies");
+    for (auto body_id : body_ids)
+    {
+        b2DestroyBody(body_id);
+    }
+}
+
 void Physics::update(double delta_time)
 {
+    PROFILE_ZONE("Physics::update");
     b2World_Step(m_world_id, static_cast<float>(delta_time), 4);
+    collect_events();
+}
+
+void Physics::collect_events()
+{
+    m_contact_begin_events.clear();
+    m_contact_end_events.clear();
+    m_sensor_begin_events.clear();
+    m_sensor_end_events.clear();
+    m_move_events.clear();
+
+    b2BodyEvents body_events = b2World_GetBodyEvents(m_world_id);
+    for (int i = 0; i < body_events.moveCount; ++i)
+    {
+        const auto &event = body_events.moveEvents[i];
+        m_move_events.push_back(PhysicsMoveEvent{
+            .entity = entity_from_user_data(event.userData),
+            .position = glm::vec2(event.transform.p.x, event.transform.p.y),
+            .fell_asleep = event.fellAsleep,
+        });
+    }
+
+    b2ContactEvents contact_events = b2World_GetContactEvents(m_world_id);
+    for (int i = 0; i < contact_events.beginCount; ++i)
+    {
+        const auto &event = contact_events.beginEvents[i];
+        m_contact_begin_events.push_back(PhysicsContactEvent{
+            .a = entity_from_shape(event.shapeIdA),
+            .b = entity_from_shape(event.shapeIdB),
+        });
+    }
+    for (int i = 0; i < contact_events.endCount; ++i)
+    {
+        const auto &event = contact_events.endEvents[i];
+        m_contact_end_events.push_back(PhysicsContactEvent{
+            .a = entity_from_shape(event.shapeIdA),
+            .b = entity_from_shape(event.shapeIdB),
+        });
+    }
+
+    b2SensorEvents sensor_events = b2World_GetSensorEvents(m_world_id);
+    for (int i = 0; i < sensor_events.beginCount; ++i)
+    {
+        const auto &event = sensor_events.beginEvents[i];
+        m_sensor_begin_events.push_back(PhysicsSensorEvent{
+            .sensor = entity_from_shape(event.sensorShapeId),
+            .visitor = entity_from_shape(event.visitorShapeId),
+        });
+    }
+    for (int i = 0; i < sensor_events.endCount; ++i)
+    {
+        const auto &event = sensor_events.endEvents[i];
+        m_sensor_end_events.push_back(PhysicsSensorEvent{
+            .sensor = entity_from_shape(event.sensorShapeId),
+            .visitor = entity_from_shape(event.visitorShapeId),
+        });
+    }
 }
 
 glm::vec2 Physics::get_position(const Collider &collider) const
@@ -101,21 +277,7 @@ glm::vec2 Physics::get_velocity(const Collider &collider) const
     }
 }
 
-[[nodiscard]] std::vector<PhysicsBodyId> Physics::get_contact_others(const Collider &collider) const
+[[nodiscard]] size_t Physics::get_body_count() const
 {
-    auto capacity = b2Body_GetContactCapacity(collider.id.value());
-    if (capacity == 0)
-    {
-        return {};
-    }
-
-    std::vector<b2ContactData> datas(capacity, b2ContactData{});
-    int count = b2Body_GetContactData(collider.id.value(), datas.data(), capacity);
-
-    std::vector<PhysicsBodyId> bodies(count, PhysicsBodyId{});
-    for (int i = 0; i < count; ++i)
-    {
-        bodies[i] = b2Shape_GetBody(datas[i].shapeIdA);
-    }
-    return bodies;
+    return static_cast<size_t>(b2World_GetCounts(m_world_id).bodyCount);
 }
@@ -1,32 +1,82 @@
 #pragma once
 
 #include <optional>
+#include <span>
 #include <vector>
 
 #include <box2d/box2d.h>
+#include <entt/entt.hpp>
 #include <glm/glm.hpp>
 
 typedef b2BodyId PhysicsBodyId;
 
+class JobSystem;
 struct Transform;
 struct Collider;
 
+struct PhysicsContactEvent
+{
+    entt::entity a;
+    entt::entity b;
+};
+
+struct PhysicsSensorEvent
+{
+    entt::entity sensor;
+    entt::entity visitor;
+};
+
+struct PhysicsBox
+{
+    glm::vec2 center;
+    glm::vec2 size;
+};
+
+struct PhysicsMoveEvent
+{
+    entt::entity entity;
+    glm::vec2 position;
+    bool fell_asleep;
+};
+
 class Physics
 {
     b2WorldId m_world_id;
 
+    // events of the last step, translated from shape ids to the entities owning the bodies
+    std::vector<PhysicsContactEvent> m_contact_begin_events;
+    std::vector<PhysicsContactEvent> m_contact_end_events;
+    std::vector<PhysicsSensorEvent> m_sensor_begin_events;
+    std::vector<PhysicsSensorEvent> m_sensor_end_events;
+    std::vector<PhysicsMoveEvent> m_move_events;
+
     Physics(const Physics &) = delete;
     Physics &operator=(const Physics &) = delete;
     Physics(Physics &&) = delete;
     Physics &operator=(Physics &&) = delete;
 
   public:
-    Physics();
+    // steps the world across the workers of `job_system`, or on the calling thread without one
+    explicit Physics(JobSystem *job_system = nullptr);
     ~Physics();
 
-    void add(const Transform &transform, Collider &collider);
+    void add(entt::entity entity, const Transform &transform, Collider &collider);
+
+    // Creates a body shaped like `collider` for every entity, at the matching position, with the
+    // body and shape definitions built once for all of them.
+    void add_bodies(
+        std::span<const entt::entity> entities, std::span<const glm::vec2> positions,
+        const Collider &collider, std::span<PhysicsBodyId> body_ids
+    );
+
     void remove(const Collider &collider);
 
+    // creates a single static body made up of all the given boxes, for level geometry that is
+    // not represented by entities
+    PhysicsBodyId add_static_boxes(std::span<const PhysicsBox> boxes);
+    void remove_body(PhysicsBodyId body_id);
+    void remove_bodies(std::span<const PhysicsBodyId> body_ids);
+
     void update(double delta_time);
 
     [[nodiscard]] glm::vec2 get_position(const Collider &collider) const;
@@ -36,7 +86,37 @@ class Physics
 
     [[nodiscard]] std::optional<glm::vec2> get_contact_normal(const Collider &collider) const;
 
-    [[nodiscard]] std::vector<PhysicsBodyId> get_contact_others(const Collider &collider) const;
+    // bodies of entities and level geometry alike
+    [[nodiscard]] size_t get_body_count() const;
+
+    [[nodiscard]] std::span<const PhysicsContactEvent> get_contact_begin_events() const
+    {
+        return m_contact_begin_events;
+    }
+
+    [[nodiscard]] std::span<const PhysicsContactEvent> get_contact_end_events() const
+    {
+        return m_contact_end_events;
+    }
+
+    [[nodiscard]] std::span<const PhysicsSensorEvent> get_sensor_begin_events() const
+    {
+        return m_sensor_begin_events;
+    }
+
+    [[nodiscard]] std::span<const PhysicsSensorEvent> get_sensor_end_events() const
+    {
+        return m_sensor_end_events;
+    }
+
+    // only bodies that moved during the last step, static and sleeping bodies never show up
+    [[nodiscard]] std::span<const PhysicsMoveEvent> get_move_events() const
+    {
+        return m_move_events;
+    }
+
+  private:
+    void collect_events();
 };
 
 inline bool operator==(const PhysicsBodyId &a, const PhysicsBodyId &b)
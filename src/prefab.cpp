@@ -0,0 +1,79 @@
+#include "prefab.hpp"
+
+#include <cassert>
+
+#include "profiler.hpp"
+
+void PrefabLibrary::add(std::string name, Prefab prefab)
+{
+    m_prefabs.insert_or_assign(std::move(name), std::move(prefab));
+}
+
+const Prefab *PrefabLibrary::find(std::string_view name) const
+{
+    auto it = m_prefabs.find(std::string(name));
+    return it != m_prefabs.end() ? &it->second : nullptr;
+}
+
+void PrefabSpawner::spawn(
+    entt::registry &registry, const Prefab &prefab, std::span<const glm::vec2> positions,
+    std::span<entt::entity> entities
+)
+{
+    PROFILE_ZONE("PrefabSpawner::spawn");
+    assert(entities.size() == positions.size());
+    if (entities.empty())
+    {
+        return;
+    }
+
+    registry.create(entities.begin(), entities.end());
+
+    m_transforms.clear();
+    for (const glm::vec2 &position : positions)
+    {
+        m_transforms.push_back(Transform{.position = position});
+    }
+    // listeners of the components below may read the transform
+    registry.insert<Transform>(entities.begin(), entities.end(), m_transforms.begin());
+
+    if (prefab.sprite)
+    {
+        registry.insert<Sprite>(entities.begin(), entities.end(), *prefab.sprite);
+    }
+
+    if (prefab.collider)
+    {
+        m_body_ids.resize(entities.size());
+        m_physics->add_bodies(entities, positions, *prefab.collider, m_body_ids);
+
+        m_colliders.assign(entities.size(), *prefab.collider);
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            m_colliders[i].id = m_body_ids[i];
+        }
+        registry.insert<Collider>(entities.begin(), entities.end(), m_colliders.begin());
+
+        if (prefab.collider->type == Collider::Type::dynamic)
+        {
+            m_interpolations.clear();
+            for (const glm::vec2 &position : positions)
+            {
+                m_interpolations.push_back(PhysicsInterpolation{
+                    .previous_position = position,
+                    .current_position = position,
+                });
+            }
+            registry.insert<PhysicsInterpolation>(
+                entities.begin(),
+                entities.end(),
+                m_interpolations.begin()
+            );
+        }
+    }
+
+    for (const PrefabComponent &component : prefab.components)
+    {
+        component(registry, entities);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include "ecs.hpp"
+#include "physics.hpp"
+
+// Adds one component, the same for every entity, to a batch of freshly spawned entities.
+typedef std::function<void(entt::registry &registry, std::span<const entt::entity> entities)>
+    PrefabComponent;
+
+// A `PrefabComponent` adding a copy of `value`, or a tag when `T` is empty.
+template<typename T>
+[[nodiscard]] PrefabComponent prefab_component(T value = {})
+{
+    return [value = std::move(value)](
+               entt::registry &registry, std::span<const entt::entity> entities
+           ) { registry.insert<T>(entities.begin(), entities.end(), value); };
+}
+
+// Components shared by every entity spawned from it, only the position differs per entity.
+// Sprites and colliders need their own setup, any other component is added through `components`.
+struct Prefab
+{
+    std::optional<Sprite> sprite;
+    std::optional<Collider> collider;
+    std::vector<PrefabComponent> components;
+};
+
+class PrefabLibrary
+{
+    std::unordered_map<std::string, Prefab> m_prefabs;
+
+  public:
+    // replaces any prefab of the same name
+    void add(std::string name, Prefab prefab);
+
+    [[nodiscard]] const Prefab *find(std::string_view name) const;
+};
+
+// Spawns many entities from a prefab at once. Entities are created with a single `create` call and
+// every component is added to all of them with one range `insert`. Bodies are created in a batch
+// before the colliders are inserted, so `Collider` listeners find them already set and must leave
+// colliders that have a body alone.
+class PrefabSpawner
+{
+    Physics *m_physics;
+
+    std::vector<Transform> m_transforms;
+    std::vector<PhysicsBodyId> m_body_ids;
+    std::vector<Collider> m_colliders;
+    std::vector<PhysicsInterpolation> m_interpolations;
+
+  public:
+    explicit PrefabSpawner(Physics *physics) : m_physics(physics)
+    {
+    }
+
+    // fills `entities`, which must be as long as `positions`
+    void spawn(
+        entt::registry &registry, const Prefab &prefab, std::span<const glm::vec2> positions,
+        std::span<entt::entity> entities
+    );
+};
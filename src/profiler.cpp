@@ -0,0 +1,285 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include <spdlog/spdlog.h>
+
+std::atomic<bool> Profiler::s_enabled{false};
+thread_local uint32_t ProfileZone::s_depth = 0;
+
+namespace
+{
+
+// single producer (the owning thread), single consumer (`Profiler::end_frame`)
+struct ThreadRing
+{
+    uint32_t thread_id{0};
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+    std::array<ProfileEvent, Profiler::THREAD_RING_CAPACITY> events;
+};
+
+struct ZoneWindow
+{
+    std::array<uint64_t, Profiler::SUMMARY_WINDOW> durations_ns{};
+    size_t count{0};
+    size_t next{0};
+};
+
+struct ProfilerState
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    uint32_t next_thread_id{0};
+    std::atomic<uint64_t> frame{0};
+
+    std::unordered_map<std::string_view, ZoneWindow> windows;
+
+    bool record_trace{false};
+    bool trace_truncated{false};
+    std::vector<ProfileEvent> trace;
+};
+
+ProfilerState &get_state()
+{
+    static ProfilerState state;
+    return state;
+}
+
+ThreadRing &get_thread_ring()
+{
+    thread_local std::shared_ptr<ThreadRing> ring = [] {
+        auto &state = get_state();
+        std::lock_guard lock(state.mutex);
+        auto ring = std::make_shared<ThreadRing>();
+        ring->thread_id = state.next_thread_id++;
+        state.rings.push_back(ring);
+        return ring;
+    }();
+    return *ring;
+}
+
+void write_json_string(std::ofstream &out, std::string_view str)
+{
+    out << '"';
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+} // namespace
+
+void Profiler::set_enabled(bool enabled, bool record_trace)
+{
+    auto &state = get_state();
+    {
+        std::lock_guard lock(state.mutex);
+        state.record_trace = enabled && record_trace;
+    }
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now_ns()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()
+    );
+}
+
+void Profiler::push(const char *name, uint64_t start_ns, uint64_t end_ns, uint32_t depth)
+{
+    ThreadRing &ring = get_thread_ring();
+
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= THREAD_RING_CAPACITY)
+    {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring.events[head % THREAD_RING_CAPACITY] = ProfileEvent{
+        .name = name,
+        .start_ns = start_ns,
+        .end_ns = end_ns,
+        .frame = get_state().frame.load(std::memory_order_relaxed),
+        .thread_id = ring.thread_id,
+        .depth = depth,
+    };
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::end_frame()
+{
+    auto &state = get_state();
+    if (!is_enabled())
+    {
+        return;
+    }
+
+    std::lock_guard lock(state.mutex);
+    for (const auto &ring : state.rings)
+    {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail)
+        {
+            const ProfileEvent &event = ring->events[tail % THREAD_RING_CAPACITY];
+
+            ZoneWindow &window = state.windows[event.name];
+            window.durations_ns[window.next] = event.end_ns - event.start_ns;
+            window.next = (window.next + 1) % SUMMARY_WINDOW;
+            window.count = std::min(window.count + 1, SUMMARY_WINDOW);
+
+            if (state.record_trace)
+            {
+                if (state.trace.size() < MAX_TRACE_EVENTS)
+                {
+                    state.trace.push_back(event);
+                }
+                else if (!state.trace_truncated)
+                {
+                    state.trace_truncated = true;
+                    spdlog::warn(
+                        "Profiler::end_frame: trace is full, dropping events after {}",
+                        MAX_TRACE_EVENTS
+                    );
+                }
+            }
+        }
+        ring->tail.store(head, std::memory_order_release);
+    }
+
+    state.frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<ProfileZoneSummary> Profiler::get_summary()
+{
+    auto &state = get_state();
+    std::lock_guard lock(state.mutex);
+
+    std::vector<ProfileZoneSummary> summary;
+    std::vector<uint64_t> durations;
+    for (const auto &[name, window] : state.windows)
+    {
+        if (window.count == 0)
+        {
+            continue;
+        }
+
+        durations.assign(
+            window.durations_ns.begin(),
+            window.durations_ns.begin() + static_cast<ptrdiff_t>(window.count)
+        );
+        std::sort(durations.begin(), durations.end());
+
+        uint64_t total = 0;
+        for (uint64_t duration : durations)
+        {
+            total += duration;
+        }
+
+        size_t p99_idx = std::min(durations.size() - 1, durations.size() * 99 / 100);
+        summary.push_back(ProfileZoneSummary{
+            .name = std::string(name),
+            .samples = window.count,
+            .min_ms = static_cast<double>(durations.front()) / 1e6,
+            .avg_ms = static_cast<double>(total) / static_cast<double>(window.count) / 1e6,
+            .p99_ms = static_cast<double>(durations[p99_idx]) / 1e6,
+        });
+    }
+
+    std::sort(summary.begin(), summary.end(), [](const auto &a, const auto &b) {
+        return a.name < b.name;
+    });
+    return summary;
+}
+
+void Profiler::log_summary()
+{
+    for (const auto &zone : get_summary())
+    {
+        spdlog::info(
+            "Profiler: {:<40} min {:8.3f}ms  avg {:8.3f}ms  p99 {:8.3f}ms  ({} samples)",
+            zone.name,
+            zone.min_ms,
+            zone.avg_ms,
+            zone.p99_ms,
+            zone.samples
+        );
+    }
+
+    auto &state = get_state();
+    std::lock_guard lock(state.mutex);
+    for (const auto &ring : state.rings)
+    {
+        uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+        if (dropped > 0)
+        {
+            spdlog::warn(
+                "Profiler: thread {} dropped {} events because its ring buffer was full",
+                ring->thread_id,
+                dropped
+            );
+        }
+    }
+}
+
+bool Profiler::export_chrome_trace(const std::string &path)
+{
+    auto &state = get_state();
+    std::lock_guard lock(state.mutex);
+
+    std::ofstream out(path);
+    if (!out.is_open())
+    {
+        spdlog::error("Profiler::export_chrome_trace: failed to open file {}", path);
+        return false;
+    }
+
+    uint64_t origin_ns = UINT64_MAX;
+    for (const auto &event : state.trace)
+    {
+        origin_ns = std::min(origin_ns, event.start_ns);
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < state.trace.size(); ++i)
+    {
+        const ProfileEvent &event = state.trace[i];
+        if (i > 0)
+        {
+            out << ',';
+        }
+        out << "\n{\"name\":";
+        write_json_string(out, event.name);
+        out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread_id
+            << ",\"ts\":" << static_cast<double>(event.start_ns - origin_ns) / 1e3
+            << ",\"dur\":" << static_cast<double>(event.end_ns - event.start_ns) / 1e3
+            << ",\"args\":{\"frame\":" << event.frame << ",\"depth\":" << event.depth << "}}";
+    }
+    out << "\n]}\n";
+
+    spdlog::info(
+        "Profiler::export_chrome_trace: wrote {} events to {}",
+        state.trace.size(),
+        path
+    );
+    return true;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef PLATFORMER_PROFILER
+#define PLATFORMER_PROFILER 1
+#endif
+
+struct ProfileEvent
+{
+    const char *name;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint64_t frame;
+    uint32_t thread_id;
+    uint32_t depth;
+};
+
+struct ProfileZoneSummary
+{
+    std::string name;
+    size_t samples;
+    double min_ms;
+    double avg_ms;
+    double p99_ms;
+};
+
+// Collects timed zones from any thread. Zones are written into a per-thread ring buffer
+// without locking and are drained on the main thread by `end_frame`, which also keeps a
+// rolling window of durations per zone name and, optionally, the full event history for
+// export as a Chrome trace (chrome://tracing, https://ui.perfetto.dev).
+//
+// Zone names must be string literals or otherwise outlive the profiler.
+class Profiler
+{
+    static std::atomic<bool> s_enabled;
+
+  public:
+    static constexpr size_t THREAD_RING_CAPACITY = 1 << 14;
+    static constexpr size_t SUMMARY_WINDOW = 256;
+    static constexpr size_t MAX_TRACE_EVENTS = 1 << 20;
+
+    static void set_enabled(bool enabled, bool record_trace);
+
+    [[nodiscard]] static bool is_enabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] static uint64_t now_ns();
+
+    static void push(const char *name, uint64_t start_ns, uint64_t end_ns, uint32_t depth);
+
+    static void end_frame();
+
+    [[nodiscard]] static std::vector<ProfileZoneSummary> get_summary();
+
+    static void log_summary();
+
+    [[nodiscard]] static bool export_chrome_trace(const std::string &path);
+};
+
+class ProfileZone
+{
+    static thread_local uint32_t s_depth;
+
+    const char *m_name;
+    uint64_t m_start_ns{0};
+    bool m_active;
+
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+    ProfileZone(ProfileZone &&) = delete;
+    ProfileZone &operator=(ProfileZone &&) = delete;
+
+  public:
+    explicit ProfileZone(const char *name) : m_name(name), m_active(Profiler::is_enabled())
+    {
+        if (m_active)
+        {
+            ++s_depth;
+            m_start_ns = Profiler::now_ns();
+        }
+    }
+
+    ~ProfileZone()
+    {
+        if (m_active)
+        {
+            --s_depth;
+            Profiler::push(m_name, m_start_ns, Profiler::now_ns(), s_depth);
+        }
+    }
+};
+
+#if PLATFORMER_PROFILER
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_CONCAT(profile_zone_, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
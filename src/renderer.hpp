@@ -1,56 +1,69 @@
 #pragma once
 
-#include <SDL3/SDL_gpu.h>
-#include <SDL3/SDL_video.h>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
 #include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include "asset_data.hpp"
+#include "camera.hpp"
+#include "slot_map.hpp"
 
-#include "registry.hpp"
-#include "sprite_render_pass.hpp"
-#include "texture.hpp"
+typedef SlotMapHandle TextureId;
 
-typedef size_t TextureId;
+class Tilemap;
 
-struct GPUContext
+enum class PresentMode
 {
-    SDL_GPUDevice *device;
-    Registry<GPUTexture> textures;
+    // waits for the vertical blank, never tears and is always supported
+    vsync,
+    // presents the newest frame at the vertical blank, replacing any frame still waiting
+    mailbox,
+    // presents right away, which may tear
+    immediate,
 };
 
-class Renderer
+constexpr std::string_view get_present_mode_name(PresentMode mode)
 {
-    SDL_Window *m_window{nullptr};
-    GPUContext m_gpu_context;
-
-    glm::mat4 m_camera;
-    SpriteRenderPass m_sprite_render_pass;
-
-  public:
-    Renderer() : m_sprite_render_pass(&m_gpu_context)
+    switch (mode)
     {
+    case PresentMode::vsync:
+        return "vsync";
+    case PresentMode::mailbox:
+        return "mailbox";
+    case PresentMode::immediate:
+        return "immediate";
     }
+    return "unknown";
+}
 
-    ~Renderer()
-    {
-        if (m_gpu_context.device != nullptr)
-        {
-            m_sprite_render_pass.release();
+class Renderer
+{
+  public:
+    virtual ~Renderer() = default;
 
-            m_gpu_context.textures.for_each([&](GPUTexture &texture) {
-                texture.release(m_gpu_context.device);
-            });
+    virtual void render(const entt::registry &entities) = 0;
 
-            SDL_DestroyGPUDevice(m_gpu_context.device);
-        }
-    }
+    virtual void set_camera(const Camera &camera) = 0;
 
-    [[nodiscard]] bool init(SDL_Window *window);
+    // returns false, keeping the current mode, if the mode is not supported
+    virtual bool set_present_mode(PresentMode mode) = 0;
 
-    void render(const entt::registry &entities);
+    // how many frames the CPU may queue before it waits for the GPU, from 1 to 3
+    virtual bool set_frames_in_flight(uint32_t count) = 0;
 
-    void set_camera(const glm::mat4 &camera)
-    {
-        m_camera = camera;
-    }
+    // The tilemap is drawn below all sprites and must outlive the renderer or be unset. The
+    // renderer may take and clear the list of dirty chunks of the tilemap.
+    virtual void set_tilemap(Tilemap *tilemap) = 0;
+
+    // uploads all images at once, throws if the textures could not be created
+    [[nodiscard]] virtual std::vector<TextureId>
+    new_textures(std::span<const ImageData> images) = 0;
 
-    [[nodiscard]] TextureId new_texture_from_file(const std::string &path);
+    // Stale ids are ignored. The textures must no longer be used by any sprite or tile, their
+    // ids may be handed out again with a different generation.
+    virtual void free_textures(std::span<const TextureId> ids) = 0;
 };
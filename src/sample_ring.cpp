@@ -0,0 +1,59 @@
+#include "sample_ring.hpp"
+
+#include <algorithm>
+
+SampleRing::SampleRing(size_t capacity) : m_samples(capacity)
+{
+}
+
+size_t SampleRing::write(std::span<const float> samples)
+{
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    uint64_t tail = m_tail.load(std::memory_order_acquire);
+    size_t count = std::min<size_t>(samples.size(), m_samples.size() - (head - tail));
+
+    size_t start = head % m_samples.size();
+    size_t first = std::min(count, m_samples.size() - start);
+    std::copy_n(samples.begin(), first, m_samples.begin() + static_cast<ptrdiff_t>(start));
+    std::copy_n(samples.begin() + static_cast<ptrdiff_t>(first), count - first, m_samples.begin());
+
+    m_head.store(head + count, std::memory_order_release);
+    return count;
+}
+
+void SampleRing::close()
+{
+    m_closed.store(true, std::memory_order_release);
+}
+
+std::array<std::span<const float>, 2> SampleRing::peek(size_t max_count) const
+{
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    size_t count = std::min<size_t>(max_count, head - tail);
+
+    size_t start = tail % m_samples.size();
+    size_t first = std::min(count, m_samples.size() - start);
+    return {
+        std::span<const float>(m_samples.data() + start, first),
+        std::span<const float>(m_samples.data(), count - first),
+    };
+}
+
+void SampleRing::consume(size_t count)
+{
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+void SampleRing::reset()
+{
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_closed.store(false, std::memory_order_relaxed);
+}
+
+bool SampleRing::is_finished() const
+{
+    // samples written before `close` are visible once it is
+    return m_closed.load(std::memory_order_acquire) && get_size() == 0;
+}
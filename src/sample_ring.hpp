@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Fixed-size ring of float samples shared by one writer thread and one reader thread without
+// locking. The writer `close`s the ring after its last samples, so the reader can tell the end of
+// a sound from a buffer underrun.
+class SampleRing
+{
+    std::vector<float> m_samples;
+    std::atomic<uint64_t> m_head{0};
+    std::atomic<uint64_t> m_tail{0};
+    std::atomic<bool> m_closed{false};
+
+    SampleRing(const SampleRing &) = delete;
+    SampleRing &operator=(const SampleRing &) = delete;
+    SampleRing(SampleRing &&) = delete;
+    SampleRing &operator=(SampleRing &&) = delete;
+
+  public:
+    explicit SampleRing(size_t capacity);
+
+    // writer: copies as many samples as fit and returns how many that were
+    size_t write(std::span<const float> samples);
+
+    // writer: no samples follow the ones already written
+    void close();
+
+    // reader: up to `max_count` of the oldest samples, in two parts when they wrap around
+    [[nodiscard]] std::array<std::span<const float>, 2> peek(size_t max_count) const;
+
+    // reader: drops the oldest `count` samples, which must have been peeked
+    void consume(size_t count);
+
+    // empties and reopens the ring, while neither the writer nor the reader use it
+    void reset();
+
+    [[nodiscard]] bool is_finished() const;
+
+    [[nodiscard]] size_t get_size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t get_free() const
+    {
+        return m_samples.size() - get_size();
+    }
+
+    [[nodiscard]] size_t get_capacity() const
+    {
+        return m_samples.size();
+    }
+};
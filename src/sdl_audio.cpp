@@ -0,0 +1,194 @@
+#include "sdl_audio.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+SDLAudio::~SDLAudio()
+{
+    if (m_stream != nullptr)
+    {
+        // also closes the device and waits for a running callback to finish, before the
+        // streaming sources the callback reads from are destroyed
+        SDL_DestroyAudioStream(m_stream);
+    }
+}
+
+bool SDLAudio::init()
+{
+    SDL_AudioSpec device_spec{};
+    if (!SDL_GetAudioDeviceFormat(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &device_spec, nullptr))
+    {
+        spdlog::error("SDLAudio::init: failed to get audio device format: {}", SDL_GetError());
+        return false;
+    }
+
+    // mix in stereo floats at the device's rate, so SDL only has to change the sample format
+    // and channel layout if the device needs it
+    m_spec = SDL_AudioSpec{
+        .format = SDL_AUDIO_F32,
+        .channels = AudioMixer::CHANNELS,
+        .freq = device_spec.freq,
+    };
+    m_mixer = std::make_unique<AudioMixer>(static_cast<uint32_t>(m_spec.freq));
+    m_mix_buffer.resize(MIX_FRAMES * AudioMixer::CHANNELS);
+
+    m_stream = SDL_OpenAudioDeviceStream(
+        SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK,
+        &m_spec,
+        on_stream_request,
+        this
+    );
+    if (m_stream == nullptr)
+    {
+        spdlog::error("SDLAudio::init: failed to open audio device: {}", SDL_GetError());
+        return false;
+    }
+
+    if (!SDL_ResumeAudioStreamDevice(m_stream))
+    {
+        spdlog::error("SDLAudio::init: failed to start audio device: {}", SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
+[[nodiscard]] std::optional<AudioSourceId> SDLAudio::new_source(WavData wav)
+{
+    uint8_t *converted = nullptr;
+    int converted_size = 0;
+    if (!SDL_ConvertAudioSamples(
+            &wav.spec,
+            wav.samples.data(),
+            static_cast<int>(wav.samples.size()),
+            &m_spec,
+            &converted,
+            &converted_size
+        ))
+    {
+        spdlog::error("SDLAudio::new_source: failed to convert audio: {}", SDL_GetError());
+        return {};
+    }
+
+    std::vector<float> samples(static_cast<size_t>(converted_size) / sizeof(float));
+    std::memcpy(samples.data(), converted, samples.size() * sizeof(float));
+    SDL_free(converted);
+
+    SDL_LockAudioStream(m_stream);
+    AudioSourceId id = m_mixer->add_sound(std::move(samples));
+    SDL_UnlockAudioStream(m_stream);
+    return id;
+}
+
+void SDLAudio::free_source(AudioSourceId id)
+{
+    SDL_LockAudioStream(m_stream);
+    m_mixer->remove_sound(id);
+    SDL_UnlockAudioStream(m_stream);
+}
+
+AudioVoiceId SDLAudio::play(AudioSourceId id, float gain, float pan, float pitch)
+{
+    return m_commands.play(id, gain, pan, pitch);
+}
+
+void SDLAudio::stop(AudioVoiceId voice)
+{
+    m_commands.stop(voice);
+}
+
+void SDLAudio::set_voice_params(AudioVoiceId voice, float gain, float pan)
+{
+    m_commands.set_voice_params(voice, gain, pan);
+}
+
+void SDLAudio::set_voice_pitch(AudioVoiceId voice, float pitch)
+{
+    m_commands.set_voice_pitch(voice, pitch);
+}
+
+[[nodiscard]] std::optional<AudioStreamId> SDLAudio::new_stream(const std::string &path, bool loop)
+{
+    auto source = std::make_unique<StreamingSource>(static_cast<uint32_t>(m_spec.freq));
+    if (!source->open(path, loop))
+    {
+        spdlog::error("SDLAudio::new_stream: failed to open stream {}", path);
+        return {};
+    }
+
+    return m_streams.insert(std::move(source));
+}
+
+void SDLAudio::play_stream(AudioStreamId id, float gain, float pan)
+{
+    auto *stream = m_streams.find(id);
+    if (stream == nullptr)
+    {
+        return;
+    }
+
+    StreamingSource &source = **stream;
+    stop_stream(id);
+    if (!source.start())
+    {
+        return;
+    }
+
+    SDL_LockAudioStream(m_stream);
+    bool added = m_mixer->add_stream(&source.get_ring(), gain, pan);
+    SDL_UnlockAudioStream(m_stream);
+    if (!added)
+    {
+        spdlog::warn(
+            "SDLAudio::play_stream: {} streams are already playing",
+            AudioMixer::STREAM_COUNT
+        );
+        source.stop();
+    }
+}
+
+void SDLAudio::stop_stream(AudioStreamId id)
+{
+    auto *stream = m_streams.find(id);
+    if (stream == nullptr)
+    {
+        return;
+    }
+
+    StreamingSource &source = **stream;
+
+    // the mixer must stop reading the ring before the source resets it
+    SDL_LockAudioStream(m_stream);
+    m_mixer->remove_stream(&source.get_ring());
+    SDL_UnlockAudioStream(m_stream);
+    source.stop();
+}
+
+void SDLAudio::free_stream(AudioStreamId id)
+{
+    stop_stream(id);
+    m_streams.erase(id);
+}
+
+void SDLCALL SDLAudio::on_stream_request(
+    void *userdata,
+    SDL_AudioStream *stream,
+    int additional_amount,
+    int /*total_amount*/
+)
+{
+    // SDL holds the stream lock while it runs the callback
+    auto *audio = static_cast<SDLAudio *>(userdata);
+    audio->m_commands.apply(*audio->m_mixer);
+
+    constexpr size_t frame_size = sizeof(float) * AudioMixer::CHANNELS;
+    size_t frames = (static_cast<size_t>(additional_amount) + frame_size - 1) / frame_size;
+    while (frames > 0)
+    {
+        size_t count = std::min(frames, MIX_FRAMES);
+        std::span<float> output(audio->m_mix_buffer.data(), count * AudioMixer::CHANNELS);
+        audio->m_mixer->mix(output);
+        SDL_PutAudioStreamData(stream, output.data(), static_cast<int>(output.size_bytes()));
+        frames -= count;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <SDL3/SDL_audio.h>
+#include <spdlog/spdlog.h>
+
+#include "audio.hpp"
+#include "audio_command_queue.hpp"
+#include "audio_mixer.hpp"
+#include "slot_map.hpp"
+#include "streaming_source.hpp"
+
+// Plays every sound through a single device stream whose callback runs `AudioMixer`. Sounds are
+// converted to the mixer's format when they are loaded, streams while they play.
+class SDLAudio final : public Audio
+{
+    // frames mixed per iteration of the callback, so the mix buffer never grows on the
+    // audio thread
+    static constexpr size_t MIX_FRAMES = 1024;
+
+    SDL_AudioStream *m_stream{nullptr};
+    SDL_AudioSpec m_spec{};
+
+    std::unique_ptr<AudioMixer> m_mixer;
+    std::vector<float> m_mix_buffer;
+    // voice calls go through the queue, so they never wait for the callback to finish
+    AudioCommandQueue m_commands;
+    SlotMap<std::unique_ptr<StreamingSource>> m_streams;
+
+    SDLAudio(const SDLAudio &) = delete;
+    SDLAudio &operator=(const SDLAudio &) = delete;
+    SDLAudio(SDLAudio &&) = delete;
+    SDLAudio &operator=(SDLAudio &&) = delete;
+
+  public:
+    SDLAudio() = default;
+
+    ~SDLAudio() override;
+
+    bool init();
+
+    [[nodiscard]] std::optional<AudioSourceId> new_source(WavData wav) override;
+
+    void free_source(AudioSourceId id) override;
+
+    AudioVoiceId play(
+        AudioSourceId id, float gain = 1.0f, float pan = 0.0f, float pitch = 1.0f
+    ) override;
+
+    void stop(AudioVoiceId voice) override;
+
+    void set_voice_params(AudioVoiceId voice, float gain, float pan) override;
+
+    void set_voice_pitch(AudioVoiceId voice, float pitch) override;
+
+    [[nodiscard]] std::optional<AudioStreamId> new_stream(
+        const std::string &path,
+        bool loop
+    ) override;
+
+    void play_stream(AudioStreamId id, float gain = 1.0f, float pan = 0.0f) override;
+
+    void stop_stream(AudioStreamId id) override;
+
+    void free_stream(AudioStreamId id) override;
+
+  private:
+    static void SDLCALL on_stream_request(
+        void *userdata,
+        SDL_AudioStream *stream,
+        int additional_amount,
+        int total_amount
+    );
+};
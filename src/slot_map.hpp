@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cassert>
+#include <compare>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Handle to a value in a `SlotMap`. The generation tells apart values that reused the same slot,
+// so a handle to an erased value never finds its replacement.
+struct SlotMapHandle
+{
+    uint32_t index{UINT32_MAX};
+    uint32_t generation{0};
+
+    auto operator<=>(const SlotMapHandle &) const = default;
+};
+
+// Stores values densely for iteration and hands out handles that stay valid until the value is
+// erased. Erasing moves the last value into the hole, so values can move but handles never do.
+// Freed slots are reused from a free list, so memory is bounded by the peak number of values.
+template<typename T>
+class SlotMap
+{
+    static constexpr uint32_t END_OF_FREE_LIST = UINT32_MAX;
+
+    struct Slot
+    {
+        // dense index while the slot is used, next free slot while it is not
+        uint32_t index;
+        // odd while the slot is used, even while it is free
+        uint32_t generation;
+    };
+
+    std::vector<T> m_values;
+    std::vector<uint32_t> m_value_slots;
+    std::vector<Slot> m_slots;
+    uint32_t m_free_head{END_OF_FREE_LIST};
+
+  public:
+    [[nodiscard]] SlotMapHandle insert(T value)
+    {
+        uint32_t slot_index = m_free_head;
+        if (slot_index == END_OF_FREE_LIST)
+        {
+            slot_index = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back(Slot{.index = 0, .generation = 0});
+        }
+        else
+        {
+            m_free_head = m_slots[slot_index].index;
+        }
+
+        Slot &slot = m_slots[slot_index];
+        slot.index = static_cast<uint32_t>(m_values.size());
+        ++slot.generation;
+        m_values.push_back(std::move(value));
+        m_value_slots.push_back(slot_index);
+
+        return SlotMapHandle{.index = slot_index, .generation = slot.generation};
+    }
+
+    // returns false if the handle is stale
+    bool erase(SlotMapHandle handle)
+    {
+        if (!contains(handle))
+        {
+            return false;
+        }
+
+        Slot &slot = m_slots[handle.index];
+        uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+        if (slot.index != last)
+        {
+            m_values[slot.index] = std::move(m_values[last]);
+            m_value_slots[slot.index] = m_value_slots[last];
+            m_slots[m_value_slots[last]].index = slot.index;
+        }
+        m_values.pop_back();
+        m_value_slots.pop_back();
+
+        ++slot.generation;
+        slot.index = m_free_head;
+        m_free_head = handle.index;
+        return true;
+    }
+
+    void clear()
+    {
+        for (uint32_t slot_index : m_value_slots)
+        {
+            Slot &slot = m_slots[slot_index];
+            ++slot.generation;
+            slot.index = m_free_head;
+            m_free_head = slot_index;
+        }
+        m_values.clear();
+        m_value_slots.clear();
+    }
+
+    [[nodiscard]] bool contains(SlotMapHandle handle) const
+    {
+        // used slots have odd generations, which also rejects handles made up from nothing
+        return handle.index < m_slots.size() && (handle.generation & 1) != 0 &&
+               m_slots[handle.index].generation == handle.generation;
+    }
+
+    // null if the handle is stale
+    [[nodiscard]] T *find(SlotMapHandle handle)
+    {
+        return contains(handle) ? &m_values[m_slots[handle.index].index] : nullptr;
+    }
+
+    [[nodiscard]] const T *find(SlotMapHandle handle) const
+    {
+        return contains(handle) ? &m_values[m_slots[handle.index].index] : nullptr;
+    }
+
+    // the handle must not be stale
+    [[nodiscard]] T &get(SlotMapHandle handle)
+    {
+        assert(contains(handle));
+        return m_values[m_slots[handle.index].index];
+    }
+
+    [[nodiscard]] const T &get(SlotMapHandle handle) const
+    {
+        assert(contains(handle));
+        return m_values[m_slots[handle.index].index];
+    }
+
+    [[nodiscard]] std::span<T> get_values()
+    {
+        return m_values;
+    }
+
+    [[nodiscard]] std::span<const T> get_values() const
+    {
+        return m_values;
+    }
+
+    // the handles of `get_values()`, in the same order
+    [[nodiscard]] SlotMapHandle get_handle(size_t dense_index) const
+    {
+        uint32_t slot_index = m_value_slots[dense_index];
+        return SlotMapHandle{.index = slot_index, .generation = m_slots[slot_index].generation};
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_values.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return m_values.empty();
+    }
+};
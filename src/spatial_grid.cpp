@@ -0,0 +1,159 @@
+#include "spatial_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static uint64_t cell_key(int32_t x, int32_t y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+SpatialGrid::SpatialGrid(float cell_size) : m_cell_size(cell_size)
+{
+}
+
+void SpatialGrid::insert(entt::entity entity, const Aabb &bounds)
+{
+    auto idx = static_cast<size_t>(entt::to_entity(entity));
+    if (idx >= m_entries.size())
+    {
+        m_entries.resize(idx + 1);
+    }
+
+    Entry &entry = m_entries[idx];
+    if (entry.entity != entt::null)
+    {
+        remove_from_cells(entry.entity, entry.first_cell, entry.last_cell);
+        --m_size;
+    }
+
+    entry = Entry{
+        .entity = entity,
+        .bounds = bounds,
+        .first_cell = get_cell(bounds.min),
+        .last_cell = get_cell(bounds.max),
+    };
+    add_to_cells(entity, entry.first_cell, entry.last_cell);
+    ++m_size;
+}
+
+void SpatialGrid::update(entt::entity entity, const Aabb &bounds)
+{
+    if (!contains(entity))
+    {
+        insert(entity, bounds);
+        return;
+    }
+
+    Entry &entry = m_entries[static_cast<size_t>(entt::to_entity(entity))];
+    entry.bounds = bounds;
+
+    glm::ivec2 first_cell = get_cell(bounds.min);
+    glm::ivec2 last_cell = get_cell(bounds.max);
+    if (first_cell == entry.first_cell && last_cell == entry.last_cell)
+    {
+        return;
+    }
+
+    remove_from_cells(entity, entry.first_cell, entry.last_cell);
+    entry.first_cell = first_cell;
+    entry.last_cell = last_cell;
+    add_to_cells(entity, first_cell, last_cell);
+}
+
+void SpatialGrid::remove(entt::entity entity)
+{
+    if (!contains(entity))
+    {
+        return;
+    }
+
+    Entry &entry = m_entries[static_cast<size_t>(entt::to_entity(entity))];
+    remove_from_cells(entity, entry.first_cell, entry.last_cell);
+    entry.entity = entt::null;
+    --m_size;
+}
+
+bool SpatialGrid::contains(entt::entity entity) const
+{
+    auto idx = static_cast<size_t>(entt::to_entity(entity));
+    return idx < m_entries.size() && m_entries[idx].entity == entity;
+}
+
+void SpatialGrid::query(const Aabb &area, std::vector<entt::entity> &result) const
+{
+    glm::ivec2 first_cell = get_cell(area.min);
+    glm::ivec2 last_cell = get_cell(area.max);
+
+    for (int32_t y = first_cell.y; y <= last_cell.y; ++y)
+    {
+        for (int32_t x = first_cell.x; x <= last_cell.x; ++x)
+        {
+            auto cell = m_cells.find(cell_key(x, y));
+            if (cell == m_cells.end())
+            {
+                continue;
+            }
+
+            for (const auto entity : cell->second)
+            {
+                const Entry &entry = m_entries[static_cast<size_t>(entt::to_entity(entity))];
+                // an entity spanning several cells is only reported by the first of its cells
+                // that lies inside the queried area, which avoids a separate deduplication pass
+                if (std::max(entry.first_cell.x, first_cell.x) != x ||
+                    std::max(entry.first_cell.y, first_cell.y) != y)
+                {
+                    continue;
+                }
+                if (entry.bounds.overlaps(area))
+                {
+                    result.push_back(entity);
+                }
+            }
+        }
+    }
+}
+
+glm::ivec2 SpatialGrid::get_cell(const glm::vec2 &position) const
+{
+    return glm::ivec2(
+        static_cast<int32_t>(std::floor(position.x / m_cell_size)),
+        static_cast<int32_t>(std::floor(position.y / m_cell_size))
+    );
+}
+
+void SpatialGrid::add_to_cells(entt::entity entity, const glm::ivec2 &first, const glm::ivec2 &last)
+{
+    for (int32_t y = first.y; y <= last.y; ++y)
+    {
+        for (int32_t x = first.x; x <= last.x; ++x)
+        {
+            m_cells[cell_key(x, y)].push_back(entity);
+        }
+    }
+}
+
+void SpatialGrid::remove_from_cells(
+    entt::entity entity, const glm::ivec2 &first, const glm::ivec2 &last
+)
+{
+    for (int32_t y = first.y; y <= last.y; ++y)
+    {
+        for (int32_t x = first.x; x <= last.x; ++x)
+        {
+            auto cell = m_cells.find(cell_key(x, y));
+            if (cell == m_cells.end())
+            {
+                continue;
+            }
+
+            auto &entities = cell->second;
+            auto it = std::find(entities.begin(), entities.end(), entity);
+            if (it != entities.end())
+            {
+                *it = entities.back();
+                entities.pop_back();
+            }
+        }
+    }
+}
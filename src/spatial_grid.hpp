@@ -0,0 +1,59 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include "aabb.hpp"
+
+// Uniform grid over entity bounds. Every entity is listed in each cell its bounds touch, moving an
+// entity only touches the cells it enters or leaves, and most moves stay inside the same cells.
+class SpatialGrid
+{
+    struct Entry
+    {
+        entt::entity entity{entt::null};
+        Aabb bounds;
+        glm::ivec2 first_cell;
+        glm::ivec2 last_cell;
+    };
+
+    float m_cell_size;
+    std::unordered_map<uint64_t, std::vector<entt::entity>> m_cells;
+    // indexed by the entity's index, without its version
+    std::vector<Entry> m_entries;
+    size_t m_size{0};
+
+  public:
+    explicit SpatialGrid(float cell_size);
+
+    void insert(entt::entity entity, const Aabb &bounds);
+
+    void update(entt::entity entity, const Aabb &bounds);
+
+    void remove(entt::entity entity);
+
+    [[nodiscard]] bool contains(entt::entity entity) const;
+
+    // Appends every entity whose bounds overlap `area` to `result`, each exactly once.
+    void query(const Aabb &area, std::vector<entt::entity> &result) const;
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] float get_cell_size() const
+    {
+        return m_cell_size;
+    }
+
+  private:
+    [[nodiscard]] glm::ivec2 get_cell(const glm::vec2 &position) const;
+
+    void add_to_cells(entt::entity entity, const glm::ivec2 &first, const glm::ivec2 &last);
+
+    void remove_from_cells(entt::entity entity, const glm::ivec2 &first, const glm::ivec2 &last);
+};
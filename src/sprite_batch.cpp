@@ -0,0 +1,52 @@
+#include "sprite_batch.hpp"
+
+void SpriteBatch::clear()
+{
+    m_pending.clear();
+    m_instances.clear();
+    m_batches.clear();
+}
+
+void SpriteBatch::add(const SpriteInstance &instance)
+{
+    m_pending.push_back(instance);
+}
+
+void SpriteBatch::build()
+{
+    m_instances.resize(m_pending.size());
+    m_batches.clear();
+    m_page_offsets.clear();
+
+    // counting sort by atlas page, which keeps the relative order of instances that share
+    // a page and does not allocate once the buffers have grown to their working size
+    for (const auto &instance : m_pending)
+    {
+        if (instance.page >= m_page_offsets.size())
+        {
+            m_page_offsets.resize(instance.page + 1, 0);
+        }
+        ++m_page_offsets[instance.page];
+    }
+
+    uint32_t offset = 0;
+    for (uint32_t page = 0; page < m_page_offsets.size(); ++page)
+    {
+        uint32_t count = m_page_offsets[page];
+        if (count > 0)
+        {
+            m_batches.push_back(SpriteDrawBatch{
+                .page = page,
+                .first_instance = offset,
+                .instance_count = count,
+            });
+        }
+        m_page_offsets[page] = offset;
+        offset += count;
+    }
+
+    for (const auto &instance : m_pending)
+    {
+        m_instances[m_page_offsets[instance.page]++] = instance;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Matches the std430 layout of `SpriteInstance` in shaders/sprite.vert.
+struct SpriteInstance
+{
+    glm::vec4 uv_rect;
+    glm::vec2 position;
+    glm::vec2 size;
+    glm::vec2 flipped;
+    float z;
+    uint32_t page;
+};
+
+static_assert(sizeof(SpriteInstance) == 48);
+
+struct SpriteDrawBatch
+{
+    uint32_t page;
+    uint32_t first_instance;
+    uint32_t instance_count;
+};
+
+// Collects sprite instances for one frame and groups them by atlas page so that every
+// page can be drawn with a single instanced draw call. Instances sharing a page keep the
+// order in which they were added.
+class SpriteBatch
+{
+    std::vector<SpriteInstance> m_pending;
+    std::vector<SpriteInstance> m_instances;
+    std::vector<SpriteDrawBatch> m_batches;
+    std::vector<uint32_t> m_page_offsets;
+
+  public:
+    void clear();
+
+    void add(const SpriteInstance &instance);
+
+    void build();
+
+    [[nodiscard]] const std::vector<SpriteInstance> &get_instances() const
+    {
+        return m_instances;
+    }
+
+    [[nodiscard]] const std::vector<SpriteDrawBatch> &get_batches() const
+    {
+        return m_batches;
+    }
+};
@@ -0,0 +1,69 @@
+#include "sprite_culling.hpp"
+
+#include "spatial_grid.hpp"
+
+Aabb get_sprite_bounds(const Transform &transform, const Sprite &sprite)
+{
+    glm::vec2 corner = transform.position + transform.scale * glm::vec2(sprite.size);
+    return Aabb{
+        .min = glm::min(transform.position, corner),
+        .max = glm::max(transform.position, corner),
+    };
+}
+
+static void add_sprite(
+    const Transform &transform, const Sprite &sprite,
+    const std::function<const AtlasRegion &(TextureId)> &resolve_texture, SpriteBatch &batch
+)
+{
+    const AtlasRegion &region = resolve_texture(sprite.texture_id);
+    batch.add(SpriteInstance{
+        .uv_rect = region.uv_rect,
+        .position = transform.position,
+        .size = transform.scale * glm::vec2(sprite.size),
+        .flipped = glm::vec2(
+            sprite.flipped_horizontally ? -1.0f : 1.0f,
+            sprite.flipped_vertically ? -1.0f : 1.0f
+        ),
+        .z = static_cast<float>(sprite.z_index),
+        .page = region.page,
+    });
+}
+
+void build_visible_sprites(
+    const entt::registry &entities, const Camera &camera,
+    const std::function<const AtlasRegion &(TextureId)> &resolve_texture,
+    std::vector<entt::entity> &visible, SpriteBatch &batch
+)
+{
+    batch.clear();
+
+    Aabb view_bounds = camera.get_bounds();
+    auto sprites = entities.view<const Transform, const Sprite>();
+
+    if (const auto *grid = entities.ctx().find<SpatialGrid>())
+    {
+        visible.clear();
+        grid->query(view_bounds, visible);
+        for (const auto entity : visible)
+        {
+            if (sprites.contains(entity))
+            {
+                const auto [transform, sprite] = sprites.get(entity);
+                add_sprite(transform, sprite, resolve_texture, batch);
+            }
+        }
+    }
+    else
+    {
+        for (const auto [entity, transform, sprite] : sprites.each())
+        {
+            if (get_sprite_bounds(transform, sprite).overlaps(view_bounds))
+            {
+                add_sprite(transform, sprite, resolve_texture, batch);
+            }
+        }
+    }
+
+    batch.build();
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "aabb.hpp"
+#include "atlas_region.hpp"
+#include "camera.hpp"
+#include "ecs.hpp"
+#include "sprite_batch.hpp"
+
+[[nodiscard]] Aabb get_sprite_bounds(const Transform &transform, const Sprite &sprite);
+
+// Fills `batch` with the sprites that overlap the camera. Candidates come from the registry's
+// `SpatialGrid` context variable when it has one, otherwise every sprite is tested. `visible` is
+// scratch storage kept by the caller so that it does not have to be reallocated every frame.
+void build_visible_sprites(
+    const entt::registry &entities, const Camera &camera,
+    const std::function<const AtlasRegion &(TextureId)> &resolve_texture,
+    std::vector<entt::entity> &visible, SpriteBatch &batch
+);
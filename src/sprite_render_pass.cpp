@@ -1,13 +1,20 @@
 #include "sprite_render_pass.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <span>
+
 #include <entt/entt.hpp>
 #include <spdlog/spdlog.h>
 
 #include "SDL3/SDL_gpu.h"
 #include "ecs.hpp"
+#include "gpu_renderer.hpp"
+#include "profiler.hpp"
 #include "read_file.hpp"
-#include "renderer.hpp"
+#include "sprite_culling.hpp"
 #include "texture.hpp"
+#include "tilemap_chunk.hpp"
 
 void SpriteRenderPass::release()
 {
@@ -16,6 +23,70 @@ void SpriteRenderPass::release()
 
     SDL_ReleaseGPUGraphicsPipeline(m_gpu_context->device, m_pipeline);
     spdlog::trace("SpriteRenderPass::~SpriteRenderPass: released sprite render pipeline");
+
+    if (m_instance_buffer != nullptr)
+    {
+        SDL_ReleaseGPUBuffer(m_gpu_context->device, m_instance_buffer);
+    }
+    spdlog::trace("SpriteRenderPass::~SpriteRenderPass: released sprite instance buffer");
+
+    release_tilemap_chunks();
+    spdlog::trace("SpriteRenderPass::~SpriteRenderPass: released tilemap chunk buffers");
+}
+
+void SpriteRenderPass::set_tilemap(Tilemap *tilemap)
+{
+    release_tilemap_chunks();
+
+    m_tilemap = tilemap;
+    if (m_tilemap == nullptr)
+    {
+        return;
+    }
+
+    // tiles set before are built once here, later changes come from the tilemap's dirty list
+    m_tilemap->clear_dirty_chunks();
+    for (uint32_t chunk_y = 0; chunk_y < m_tilemap->get_chunk_rows(); ++chunk_y)
+    {
+        for (uint32_t chunk_x = 0; chunk_x < m_tilemap->get_chunk_columns(); ++chunk_x)
+        {
+            if (!m_tilemap->is_chunk_empty(chunk_x, chunk_y))
+            {
+                m_dirty_chunks.push_back(
+                    static_cast<size_t>(chunk_y) * m_tilemap->get_chunk_columns() + chunk_x
+                );
+            }
+        }
+    }
+}
+
+void SpriteRenderPass::release_tilemap_chunks()
+{
+    for (const auto &[chunk_idx, chunk] : m_tilemap_chunks)
+    {
+        if (chunk.buffer != nullptr)
+        {
+            SDL_ReleaseGPUBuffer(m_gpu_context->device, chunk.buffer);
+        }
+    }
+    m_tilemap_chunks.clear();
+    m_dirty_chunks.clear();
+}
+
+// Shader code comes straight out of the asset pack when it has been cooked into one, otherwise
+// it is read into `storage`.
+static std::span<const uint8_t>
+read_shader_code(const AssetPack *pack, const std::string &path, std::vector<uint8_t> &storage)
+{
+    if (pack != nullptr && pack->is_open())
+    {
+        if (auto code = pack->get_blob(get_pack_name(path)))
+        {
+            return *code;
+        }
+    }
+    storage = read_file(path);
+    return storage;
 }
 
 bool SpriteRenderPass::init(
@@ -25,11 +96,20 @@ bool SpriteRenderPass::init(
     m_depth_texture =
         GPUTexture::depth_target(m_gpu_context->device, surface_width, surface_height);
 
-    std::vector<uint8_t> vertex_shader_code, fragment_shader_code;
+    std::vector<uint8_t> vertex_shader_storage, fragment_shader_storage;
+    std::span<const uint8_t> vertex_shader_code, fragment_shader_code;
     try
     {
-        vertex_shader_code = read_file("./shaders/sprite.vert.bin");
-        fragment_shader_code = read_file("./shaders/sprite.frag.bin");
+        vertex_shader_code = read_shader_code(
+            m_gpu_context->asset_pack,
+            "./shaders/sprite.vert.bin",
+            vertex_shader_storage
+        );
+        fragment_shader_code = read_shader_code(
+            m_gpu_context->asset_pack,
+            "./shaders/sprite.frag.bin",
+            fragment_shader_storage
+        );
     }
     catch (std::exception &e)
     {
@@ -46,8 +126,8 @@ bool SpriteRenderPass::init(
         .stage = SDL_GPU_SHADERSTAGE_VERTEX,
         .num_samplers = 0,
         .num_storage_textures = 0,
-        .num_storage_buffers = 0,
-        .num_uniform_buffers = 2,
+        .num_storage_buffers = 1,
+        .num_uniform_buffers = 1,
         .props = 0,
     };
     SDL_GPUShader *vertex_shader =
@@ -166,11 +246,298 @@ bool SpriteRenderPass::init(
     return true;
 }
 
+bool SpriteRenderPass::reserve_instances(uint32_t count)
+{
+    if (count <= m_instance_capacity)
+    {
+        return true;
+    }
+
+    uint32_t capacity = std::max(m_instance_capacity, 1024u);
+    while (capacity < count)
+    {
+        capacity *= 2;
+    }
+
+    if (m_instance_buffer != nullptr)
+    {
+        SDL_ReleaseGPUBuffer(m_gpu_context->device, m_instance_buffer);
+        m_instance_buffer = nullptr;
+    }
+    m_instance_capacity = 0;
+
+    uint32_t size = capacity * static_cast<uint32_t>(sizeof(SpriteInstance));
+
+    SDL_GPUBufferCreateInfo buffer_create_info{
+        .usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
+        .size = size,
+        .props = 0,
+    };
+    m_instance_buffer = SDL_CreateGPUBuffer(m_gpu_context->device, &buffer_create_info);
+    if (!m_instance_buffer)
+    {
+        spdlog::error(
+            "SpriteRenderPass::reserve_instances: failed to create instance buffer: {}",
+            SDL_GetError()
+        );
+        return false;
+    }
+
+    m_instance_capacity = capacity;
+    spdlog::trace("SpriteRenderPass::reserve_instances: resized instance buffer to {}", capacity);
+
+    return true;
+}
+
+void SpriteRenderPass::upload_instances(SDL_GPUCommandBuffer *cmd_buffer)
+{
+    const auto &instances = m_batch.get_instances();
+    uint32_t size = static_cast<uint32_t>(instances.size() * sizeof(SpriteInstance));
+
+    std::optional<UploadAllocation> allocation = m_gpu_context->uploads.allocate(size);
+    if (!allocation)
+    {
+        spdlog::error("SpriteRenderPass::upload_instances: failed to allocate upload space");
+        return;
+    }
+    std::memcpy(allocation->data, instances.data(), size);
+    m_gpu_context->uploads.unmap();
+
+    SDL_GPUCopyPass *copy_pass = SDL_BeginGPUCopyPass(cmd_buffer);
+    {
+        SDL_GPUTransferBufferLocation source{
+            .transfer_buffer = allocation->transfer_buffer,
+            .offset = allocation->offset,
+        };
+        SDL_GPUBufferRegion destination{
+            .buffer = m_instance_buffer,
+            .offset = 0,
+            .size = size,
+        };
+        SDL_UploadToGPUBuffer(copy_pass, &source, &destination, true);
+    }
+    SDL_EndGPUCopyPass(copy_pass);
+}
+
+void SpriteRenderPass::update_tilemap_chunks(SDL_GPUCommandBuffer *cmd_buffer)
+{
+    if (m_tilemap == nullptr)
+    {
+        return;
+    }
+
+    m_chunk_instances.clear();
+    m_chunk_uploads.clear();
+
+    const std::vector<size_t> &dirty_chunks = m_tilemap->get_dirty_chunks();
+    m_dirty_chunks.insert(m_dirty_chunks.end(), dirty_chunks.begin(), dirty_chunks.end());
+    m_tilemap->clear_dirty_chunks();
+    if (m_dirty_chunks.empty())
+    {
+        return;
+    }
+
+    auto resolve_texture = [&](TextureId id) -> const AtlasRegion & {
+        return m_gpu_context->textures.get(id);
+    };
+
+    uint32_t chunk_columns = m_tilemap->get_chunk_columns();
+    for (size_t chunk_idx : m_dirty_chunks)
+    {
+        uint32_t chunk_x = static_cast<uint32_t>(chunk_idx % chunk_columns);
+        uint32_t chunk_y = static_cast<uint32_t>(chunk_idx / chunk_columns);
+
+        // chunks that were streamed out give their buffer back instead of keeping it around
+        if (m_tilemap->is_chunk_empty(chunk_x, chunk_y))
+        {
+            auto it = m_tilemap_chunks.find(chunk_idx);
+            if (it != m_tilemap_chunks.end())
+            {
+                if (it->second.buffer != nullptr)
+                {
+                    SDL_ReleaseGPUBuffer(m_gpu_context->device, it->second.buffer);
+                }
+                m_tilemap_chunks.erase(it);
+            }
+            continue;
+        }
+
+        auto &chunk = m_tilemap_chunks[chunk_idx];
+        uint64_t revision = m_tilemap->get_chunk_revision(chunk_x, chunk_y);
+        if (chunk.revision == revision)
+        {
+            continue;
+        }
+
+        build_tilemap_chunk(*m_tilemap, chunk_x, chunk_y, resolve_texture, m_chunk_batch);
+        const auto &instances = m_chunk_batch.get_instances();
+        uint32_t count = static_cast<uint32_t>(instances.size());
+
+        if (count > chunk.capacity)
+        {
+            if (chunk.buffer != nullptr)
+            {
+                SDL_ReleaseGPUBuffer(m_gpu_context->device, chunk.buffer);
+            }
+
+            SDL_GPUBufferCreateInfo buffer_create_info{
+                .usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
+                .size = count * static_cast<uint32_t>(sizeof(SpriteInstance)),
+                .props = 0,
+            };
+            chunk.buffer = SDL_CreateGPUBuffer(m_gpu_context->device, &buffer_create_info);
+            chunk.capacity = chunk.buffer != nullptr ? count : 0;
+            if (!chunk.buffer)
+            {
+                spdlog::error(
+                    "SpriteRenderPass::update_tilemap_chunks: failed to create chunk buffer: {}",
+                    SDL_GetError()
+                );
+                chunk.revision.reset();
+                chunk.batches.clear();
+                continue;
+            }
+        }
+
+        chunk.revision = revision;
+        chunk.batches = m_chunk_batch.get_batches();
+        if (count > 0)
+        {
+            m_chunk_uploads.push_back(TilemapChunkUpload{
+                .chunk_idx = chunk_idx,
+                .first_instance = static_cast<uint32_t>(m_chunk_instances.size()),
+                .instance_count = count,
+            });
+            m_chunk_instances.insert(m_chunk_instances.end(), instances.begin(), instances.end());
+        }
+    }
+
+    // chunks whose buffer could not be created stay dirty and are tried again next frame
+    std::erase_if(m_dirty_chunks, [&](size_t chunk_idx) {
+        auto it = m_tilemap_chunks.find(chunk_idx);
+        return it == m_tilemap_chunks.end() || it->second.revision.has_value();
+    });
+
+    if (m_chunk_uploads.empty())
+    {
+        return;
+    }
+
+    uint32_t size = static_cast<uint32_t>(m_chunk_instances.size() * sizeof(SpriteInstance));
+    std::optional<UploadAllocation> allocation = m_gpu_context->uploads.allocate(size);
+    if (!allocation)
+    {
+        spdlog::error("SpriteRenderPass::update_tilemap_chunks: failed to allocate upload space");
+        // rebuild the chunks again next frame
+        for (const auto &upload : m_chunk_uploads)
+        {
+            m_tilemap_chunks[upload.chunk_idx].revision.reset();
+            m_dirty_chunks.push_back(upload.chunk_idx);
+        }
+        return;
+    }
+    std::memcpy(allocation->data, m_chunk_instances.data(), size);
+    m_gpu_context->uploads.unmap();
+
+    SDL_GPUCopyPass *copy_pass = SDL_BeginGPUCopyPass(cmd_buffer);
+    for (const auto &upload : m_chunk_uploads)
+    {
+        SDL_GPUTransferBufferLocation source{
+            .transfer_buffer = allocation->transfer_buffer,
+            .offset = allocation->offset +
+                      upload.first_instance * static_cast<uint32_t>(sizeof(SpriteInstance)),
+        };
+        SDL_GPUBufferRegion destination{
+            .buffer = m_tilemap_chunks[upload.chunk_idx].buffer,
+            .offset = 0,
+            .size = upload.instance_count * static_cast<uint32_t>(sizeof(SpriteInstance)),
+        };
+        SDL_UploadToGPUBuffer(copy_pass, &source, &destination, false);
+    }
+    SDL_EndGPUCopyPass(copy_pass);
+
+    spdlog::trace(
+        "SpriteRenderPass::update_tilemap_chunks: rebuilt {} chunks",
+        m_chunk_uploads.size()
+    );
+}
+
+void SpriteRenderPass::draw_tilemap_chunks(
+    SDL_GPUCommandBuffer *cmd_buffer, SDL_GPURenderPass *render_pass, const glm::mat4 &projection,
+    const Aabb &view_bounds
+)
+{
+    if (m_tilemap == nullptr)
+    {
+        return;
+    }
+
+    // only the chunks under the camera are looked up, however large the map is
+    Tilemap::ChunkRange range = m_tilemap->get_chunk_range(view_bounds);
+    uint32_t chunk_columns = m_tilemap->get_chunk_columns();
+    for (uint32_t chunk_y = range.first_y; chunk_y < range.end_y; ++chunk_y)
+    {
+        for (uint32_t chunk_x = range.first_x; chunk_x < range.end_x; ++chunk_x)
+        {
+            auto it = m_tilemap_chunks.find(static_cast<size_t>(chunk_y) * chunk_columns + chunk_x);
+            if (it == m_tilemap_chunks.end() || it->second.buffer == nullptr ||
+                it->second.batches.empty())
+            {
+                continue;
+            }
+            const TilemapChunk &chunk = it->second;
+            draw_batches(cmd_buffer, render_pass, projection, chunk.buffer, chunk.batches);
+        }
+    }
+}
+
+void SpriteRenderPass::draw_batches(
+    SDL_GPUCommandBuffer *cmd_buffer, SDL_GPURenderPass *render_pass, const glm::mat4 &projection,
+    SDL_GPUBuffer *instance_buffer, const std::vector<SpriteDrawBatch> &batches
+)
+{
+    SDL_BindGPUVertexStorageBuffers(render_pass, 0, &instance_buffer, 1);
+
+    for (const auto &batch : batches)
+    {
+        Uniforms uniforms{
+            .camera = projection,
+            .first_instance = batch.first_instance,
+            .padding = {},
+        };
+        SDL_PushGPUVertexUniformData(cmd_buffer, 0, &uniforms, sizeof(uniforms));
+        SDL_GPUTextureSamplerBinding texture_sampler_binding =
+            m_gpu_context->atlas.get_binding(batch.page);
+        SDL_BindGPUFragmentSamplers(render_pass, 0, &texture_sampler_binding, 1);
+        SDL_DrawGPUPrimitives(render_pass, 6, batch.instance_count, 0, 0);
+    }
+}
+
 void SpriteRenderPass::render(
-    SDL_GPUCommandBuffer *cmd_buffer, SDL_GPUTexture *target_texture, const glm::mat4 &camera,
+    SDL_GPUCommandBuffer *cmd_buffer, SDL_GPUTexture *target_texture, const Camera &camera,
     const entt::registry &entities
 )
 {
+    PROFILE_ZONE("SpriteRenderPass::render");
+
+    build_visible_sprites(
+        entities,
+        camera,
+        [&](TextureId id) -> const AtlasRegion & { return m_gpu_context->textures.get(id); },
+        m_visible_sprites,
+        m_batch
+    );
+
+    const auto &instances = m_batch.get_instances();
+    bool has_instances =
+        !instances.empty() && reserve_instances(static_cast<uint32_t>(instances.size()));
+    if (has_instances)
+    {
+        upload_instances(cmd_buffer);
+    }
+
+    update_tilemap_chunks(cmd_buffer);
+
     SDL_GPUColorTargetInfo color_target_info{
         .texture = target_texture,
         .mip_level = 0,
@@ -204,27 +571,20 @@ void SpriteRenderPass::render(
     {
         SDL_BindGPUGraphicsPipeline(render_pass, m_pipeline);
 
-        auto sprites = entities.view<const Transform, const Sprite>();
-        for (const auto [entity, transform, sprite] : sprites.each())
+        glm::mat4 projection = camera.get_projection();
+        Aabb view_bounds = camera.get_bounds();
+
+        draw_tilemap_chunks(cmd_buffer, render_pass, projection, view_bounds);
+
+        if (has_instances)
         {
-            glm::mat4 z_index_matrix = glm::translate(
-                glm::mat4(1.0f),
-                glm::vec3(0.0f, 0.0f, static_cast<float>(sprite.z_index))
+            draw_batches(
+                cmd_buffer,
+                render_pass,
+                projection,
+                m_instance_buffer,
+                m_batch.get_batches()
             );
-            glm::mat4 size_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(sprite.size, 1.0f));
-            Uniforms uniforms{
-                .camera = camera,
-                .model = transform.to_matrix() * z_index_matrix * size_matrix,
-                .flipped = glm::vec2(
-                    sprite.flipped_horizontally ? -1.0 : 1.0,
-                    sprite.flipped_vertically ? -1.0 : 1.0
-                ),
-            };
-            SDL_PushGPUVertexUniformData(cmd_buffer, 0, &uniforms, sizeof(uniforms));
-            SDL_GPUTextureSamplerBinding texture_sampler_binding =
-                m_gpu_context->textures.get(sprite.texture_id).get_binding();
-            SDL_BindGPUFragmentSamplers(render_pass, 0, &texture_sampler_binding, 1);
-            SDL_DrawGPUPrimitives(render_pass, 6, 1, 0, 0);
         }
     }
     SDL_EndGPURenderPass(render_pass);
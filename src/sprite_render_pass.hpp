@@ -1,11 +1,17 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
 #include <SDL3/SDL_gpu.h>
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 #include <spdlog/spdlog.h>
 
+#include "camera.hpp"
+#include "sprite_batch.hpp"
 #include "texture.hpp"
+#include "tilemap.hpp"
 
 struct GPUContext;
 
@@ -14,14 +20,45 @@ class SpriteRenderPass
     struct Uniforms
     {
         glm::mat4 camera;
-        glm::mat4 model;
-        glm::vec2 flipped;
+        uint32_t first_instance;
+        uint32_t padding[3];
     };
 
     GPUContext *m_gpu_context;
     GPUTexture m_depth_texture;
     SDL_GPUGraphicsPipeline *m_pipeline{nullptr};
 
+    SpriteBatch m_batch;
+    std::vector<entt::entity> m_visible_sprites;
+    SDL_GPUBuffer *m_instance_buffer{nullptr};
+    uint32_t m_instance_capacity{0};
+
+    // tiles never move, so every chunk keeps its instances in its own buffer and is only
+    // rebuilt when the tilemap lists it as dirty with a new revision
+    struct TilemapChunk
+    {
+        SDL_GPUBuffer *buffer{nullptr};
+        uint32_t capacity{0};
+        std::optional<uint64_t> revision;
+        std::vector<SpriteDrawBatch> batches;
+    };
+
+    struct TilemapChunkUpload
+    {
+        size_t chunk_idx;
+        uint32_t first_instance;
+        uint32_t instance_count;
+    };
+
+    Tilemap *m_tilemap{nullptr};
+    // only chunks that have tiles, by tilemap chunk index
+    std::unordered_map<size_t, TilemapChunk> m_tilemap_chunks;
+    // taken from the tilemap and not rebuilt yet
+    std::vector<size_t> m_dirty_chunks;
+    SpriteBatch m_chunk_batch;
+    std::vector<SpriteInstance> m_chunk_instances;
+    std::vector<TilemapChunkUpload> m_chunk_uploads;
+
     SpriteRenderPass(const SpriteRenderPass &) = delete;
     SpriteRenderPass &operator=(const SpriteRenderPass &) = delete;
     SpriteRenderPass(SpriteRenderPass &&) = delete;
@@ -39,8 +76,30 @@ class SpriteRenderPass
 
     void release();
 
+    void set_tilemap(Tilemap *tilemap);
+
     void render(
-        SDL_GPUCommandBuffer *cmd_buffer, SDL_GPUTexture *target_texture, const glm::mat4 &camera,
+        SDL_GPUCommandBuffer *cmd_buffer, SDL_GPUTexture *target_texture, const Camera &camera,
         const entt::registry &entities
     );
+
+  private:
+    [[nodiscard]] bool reserve_instances(uint32_t count);
+
+    void upload_instances(SDL_GPUCommandBuffer *cmd_buffer);
+
+    void release_tilemap_chunks();
+
+    void update_tilemap_chunks(SDL_GPUCommandBuffer *cmd_buffer);
+
+    void draw_tilemap_chunks(
+        SDL_GPUCommandBuffer *cmd_buffer, SDL_GPURenderPass *render_pass,
+        const glm::mat4 &projection, const Aabb &view_bounds
+    );
+
+    void draw_batches(
+        SDL_GPUCommandBuffer *cmd_buffer, SDL_GPURenderPass *render_pass,
+        const glm::mat4 &projection, SDL_GPUBuffer *instance_buffer,
+        const std::vector<SpriteDrawBatch> &batches
+    );
 };
@@ -0,0 +1,155 @@
+#include "streaming_source.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "audio_mixer.hpp"
+#include "profiler.hpp"
+
+StreamingSource::StreamingSource(uint32_t frequency)
+    : m_output_spec{
+          .format = SDL_AUDIO_F32,
+          .channels = AudioMixer::CHANNELS,
+          .freq = static_cast<int>(frequency),
+      },
+      // whole frames, so a full ring never ends on half of a stereo frame
+      m_ring(static_cast<size_t>(frequency) * BUFFERED_MS / 1000 * AudioMixer::CHANNELS),
+      m_read_buffer(READ_CHUNK_SIZE),
+      m_convert_buffer(CONVERT_CHUNK_FRAMES * AudioMixer::CHANNELS)
+{
+}
+
+StreamingSource::~StreamingSource()
+{
+    stop();
+    if (m_converter != nullptr)
+    {
+        SDL_DestroyAudioStream(m_converter);
+    }
+}
+
+bool StreamingSource::open(const std::string &path, bool loop)
+{
+    if (!m_reader.open(path))
+    {
+        return false;
+    }
+    m_loop = loop;
+
+    m_converter = SDL_CreateAudioStream(&m_reader.get_spec(), &m_output_spec);
+    if (m_converter == nullptr)
+    {
+        spdlog::error("StreamingSource::open: failed to create audio stream: {}", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+bool StreamingSource::start()
+{
+    stop();
+
+    m_reader.rewind();
+    if (!SDL_ClearAudioStream(m_converter))
+    {
+        spdlog::error("StreamingSource::start: failed to clear audio stream: {}", SDL_GetError());
+        return false;
+    }
+    m_input_ended = false;
+    m_ring.reset();
+
+    // have the start of the track ready before the mixer first reads it
+    if (refill())
+    {
+        m_stopping = false;
+        m_thread = std::thread(&StreamingSource::run, this);
+    }
+    return true;
+}
+
+void StreamingSource::stop()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void StreamingSource::run()
+{
+    std::unique_lock lock(m_mutex);
+    while (!m_wake.wait_for(lock, REFILL_INTERVAL, [this] { return m_stopping; }))
+    {
+        lock.unlock();
+        bool playing = refill();
+        lock.lock();
+        if (!playing)
+        {
+            return;
+        }
+    }
+}
+
+bool StreamingSource::refill()
+{
+    PROFILE_ZONE("StreamingSource::refill");
+    const int convert_size = static_cast<int>(m_convert_buffer.size() * sizeof(float));
+
+    while (m_ring.get_free() >= m_convert_buffer.size())
+    {
+        if (!m_input_ended && SDL_GetAudioStreamAvailable(m_converter) < convert_size)
+        {
+            size_t read = m_reader.read(m_read_buffer);
+            if (read == 0 && m_loop && m_reader.get_data_size() > 0)
+            {
+                m_reader.rewind();
+            }
+            else if (read == 0)
+            {
+                m_input_ended = true;
+                SDL_FlushAudioStream(m_converter);
+            }
+            else if (!SDL_PutAudioStreamData(
+                         m_converter,
+                         m_read_buffer.data(),
+                         static_cast<int>(read)
+                     ))
+            {
+                spdlog::error(
+                    "StreamingSource::refill: failed to convert audio: {}",
+                    SDL_GetError()
+                );
+                m_ring.close();
+                return false;
+            }
+            continue;
+        }
+
+        int converted = SDL_GetAudioStreamData(m_converter, m_convert_buffer.data(), convert_size);
+        if (converted <= 0)
+        {
+            if (converted < 0)
+            {
+                spdlog::error(
+                    "StreamingSource::refill: failed to convert audio: {}",
+                    SDL_GetError()
+                );
+            }
+            // only reached once the input has ended, so the converter is drained
+            m_ring.close();
+            return false;
+        }
+        m_ring.write(std::span<const float>(
+            m_convert_buffer.data(),
+            static_cast<size_t>(converted) / sizeof(float)
+        ));
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL_audio.h>
+
+#include "sample_ring.hpp"
+#include "wav_reader.hpp"
+
+// Plays a long WAV file, such as a music track, without loading it. A background thread reads the
+// file in fixed-size chunks, converts them to interleaved stereo floats at the mixer's frequency
+// and keeps a ring of `BUFFERED_MS` of samples filled for the mixer to read. Memory use depends
+// only on the mixer's frequency, not on the length of the track.
+class StreamingSource
+{
+  public:
+    static constexpr uint32_t BUFFERED_MS = 500;
+    static constexpr size_t READ_CHUNK_SIZE = 16 * 1024;
+    static constexpr size_t CONVERT_CHUNK_FRAMES = 4096;
+    static constexpr std::chrono::milliseconds REFILL_INTERVAL{20};
+
+  private:
+    WavReader m_reader;
+    bool m_loop{false};
+    SDL_AudioSpec m_output_spec;
+    SDL_AudioStream *m_converter{nullptr};
+    bool m_input_ended{false};
+
+    SampleRing m_ring;
+    std::vector<uint8_t> m_read_buffer;
+    std::vector<float> m_convert_buffer;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping{false};
+
+    StreamingSource(const StreamingSource &) = delete;
+    StreamingSource &operator=(const StreamingSource &) = delete;
+    StreamingSource(StreamingSource &&) = delete;
+    StreamingSource &operator=(StreamingSource &&) = delete;
+
+  public:
+    explicit StreamingSource(uint32_t frequency);
+
+    ~StreamingSource();
+
+    [[nodiscard]] bool open(const std::string &path, bool loop);
+
+    // Starts streaming from the beginning of the track, restarting it if it is already playing.
+    [[nodiscard]] bool start();
+
+    void stop();
+
+    // read by the mixer while the source is started
+    [[nodiscard]] SampleRing &get_ring()
+    {
+        return m_ring;
+    }
+
+    // bytes held by the source's own buffers, which does not grow with the length of the track
+    [[nodiscard]] size_t get_buffer_size() const
+    {
+        return m_ring.get_capacity() * sizeof(float) + m_read_buffer.size() +
+               m_convert_buffer.size() * sizeof(float);
+    }
+
+  private:
+    void run();
+
+    // Fills the ring as far as it goes, returns false once the whole track is in it.
+    [[nodiscard]] bool refill();
+};
@@ -0,0 +1,109 @@
+#include "system_graph.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include <spdlog/spdlog.h>
+
+#include "profiler.hpp"
+
+SystemBuilder &SystemBuilder::structural()
+{
+    m_graph->m_systems[m_system].structural = true;
+    return *this;
+}
+
+SystemBuilder SystemGraph::add(const char *name, std::function<void()> run)
+{
+    m_systems.push_back(System{
+        .name = name,
+        .run = std::move(run),
+        .reads = {},
+        .writes = {},
+        .assure_storages = {},
+        .structural = false,
+    });
+    m_waves.clear();
+    return SystemBuilder(this, m_systems.size() - 1);
+}
+
+void SystemGraph::build(entt::registry &registry)
+{
+    m_waves.clear();
+    std::vector<size_t> system_waves(m_systems.size());
+    for (size_t i = 0; i < m_systems.size(); ++i)
+    {
+        for (auto assure_storage : m_systems[i].assure_storages)
+        {
+            assure_storage(registry);
+        }
+
+        size_t wave = 0;
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (conflicts(m_systems[i], m_systems[j]))
+            {
+                wave = std::max(wave, system_waves[j] + 1);
+            }
+        }
+        system_waves[i] = wave;
+
+        if (wave == m_waves.size())
+        {
+            m_waves.emplace_back();
+        }
+        m_waves[wave].push_back(i);
+    }
+
+    spdlog::info(
+        "SystemGraph::build: scheduled {} systems in {} waves",
+        m_systems.size(),
+        m_waves.size()
+    );
+}
+
+void SystemGraph::run()
+{
+    PROFILE_ZONE("SystemGraph::run");
+    assert(m_systems.empty() || !m_waves.empty());
+
+    for (const auto &wave : m_waves)
+    {
+        auto run_system = [&](size_t system_idx) {
+            const System &system = m_systems[system_idx];
+            PROFILE_ZONE(system.name);
+            system.run();
+        };
+
+        // structural systems never share a wave, so they always run on the calling thread
+        if (wave.size() == 1)
+        {
+            run_system(wave[0]);
+            continue;
+        }
+
+        auto run_systems = [&](int32_t start, int32_t end, uint32_t) {
+            for (int32_t i = start; i < end; ++i)
+            {
+                run_system(wave[static_cast<size_t>(i)]);
+            }
+        };
+        m_jobs->parallel_for(static_cast<int32_t>(wave.size()), 1, run_systems);
+    }
+}
+
+bool SystemGraph::conflicts(const System &a, const System &b)
+{
+    if (a.structural || b.structural)
+    {
+        return true;
+    }
+
+    auto writes_any = [](const System &writer, const std::vector<entt::id_type> &accesses) {
+        return std::any_of(accesses.begin(), accesses.end(), [&](entt::id_type access) {
+            return std::find(writer.writes.begin(), writer.writes.end(), access) !=
+                   writer.writes.end();
+        });
+    };
+    return writes_any(a, b.reads) || writes_any(a, b.writes) || writes_any(b, a.reads);
+}
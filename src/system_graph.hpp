@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "job_system.hpp"
+
+class SystemGraph;
+
+// Declares what a system added to a `SystemGraph` touches. Components are what the system gets
+// from the registry, resources are anything else shared between systems, such as `Physics`.
+class SystemBuilder
+{
+    SystemGraph *m_graph;
+    size_t m_system;
+
+  public:
+    SystemBuilder(SystemGraph *graph, size_t system) : m_graph(graph), m_system(system)
+    {
+    }
+
+    template<typename... Components>
+    SystemBuilder &reads();
+
+    template<typename... Components>
+    SystemBuilder &writes();
+
+    template<typename... Resources>
+    SystemBuilder &reads_resource();
+
+    template<typename... Resources>
+    SystemBuilder &writes_resource();
+
+    // Creates or destroys entities, or adds or removes components. The system then runs on its
+    // own on the thread calling `SystemGraph::run`, after every system added before it.
+    SystemBuilder &structural();
+};
+
+// Runs systems in the order they were added, except that systems whose accesses do not conflict
+// run in parallel on a job system. Two systems conflict when one writes something the other reads
+// or writes, or when either is structural. Systems are grouped into waves, each system going into
+// the wave after the last wave holding a conflicting system added before it.
+class SystemGraph
+{
+    friend class SystemBuilder;
+
+    struct System
+    {
+        const char *name;
+        std::function<void()> run;
+        std::vector<entt::id_type> reads;
+        std::vector<entt::id_type> writes;
+        // creates the storage of every declared component, views made from several threads at
+        // once must not create storages
+        std::vector<void (*)(entt::registry &)> assure_storages;
+        bool structural{false};
+    };
+
+    JobSystem *m_jobs;
+    std::vector<System> m_systems;
+    std::vector<std::vector<size_t>> m_waves;
+
+  public:
+    explicit SystemGraph(JobSystem *jobs) : m_jobs(jobs)
+    {
+    }
+
+    // `name` must outlive the graph, it is used for profiling
+    SystemBuilder add(const char *name, std::function<void()> run);
+
+    // Groups the systems into waves, must be called after the last `add` and before `run`.
+    void build(entt::registry &registry);
+
+    void run();
+
+    [[nodiscard]] size_t get_system_count() const
+    {
+        return m_systems.size();
+    }
+
+    [[nodiscard]] size_t get_wave_count() const
+    {
+        return m_waves.size();
+    }
+
+  private:
+    [[nodiscard]] static bool conflicts(const System &a, const System &b);
+};
+
+template<typename... Components>
+SystemBuilder &SystemBuilder::reads()
+{
+    auto &system = m_graph->m_systems[m_system];
+    (system.reads.push_back(entt::type_hash<Components>::value()), ...);
+    (system.assure_storages.push_back([](entt::registry &registry) {
+        static_cast<void>(registry.storage<Components>());
+    }),
+     ...);
+    return *this;
+}
+
+template<typename... Components>
+SystemBuilder &SystemBuilder::writes()
+{
+    auto &system = m_graph->m_systems[m_system];
+    (system.writes.push_back(entt::type_hash<Components>::value()), ...);
+    (system.assure_storages.push_back([](entt::registry &registry) {
+        static_cast<void>(registry.storage<Components>());
+    }),
+     ...);
+    return *this;
+}
+
+template<typename... Resources>
+SystemBuilder &SystemBuilder::reads_resource()
+{
+    auto &system = m_graph->m_systems[m_system];
+    (system.reads.push_back(entt::type_hash<Resources>::value()), ...);
+    return *this;
+}
+
+template<typename... Resources>
+SystemBuilder &SystemBuilder::writes_resource()
+{
+    auto &system = m_graph->m_systems[m_system];
+    (system.writes.push_back(entt::type_hash<Resources>::value()), ...);
+    return *this;
+}
+
+// Calls `function(entity)` for every entity of `view` in chunks of at least `min_chunk` entities
+// spread across the job system. `function` may only touch the components of its own entity.
+template<typename View, typename F>
+void parallel_each(JobSystem &jobs, const View &view, int32_t min_chunk, F &&function)
+{
+    const auto *storage = view.handle();
+    if (storage == nullptr)
+    {
+        return;
+    }
+
+    const entt::entity *entities = storage->data();
+    int32_t count = static_cast<int32_t>(storage->size());
+    jobs.parallel_for(count, min_chunk, [&](int32_t start, int32_t end, uint32_t) {
+        for (int32_t i = start; i < end; ++i)
+        {
+            // the leading storage also holds entities missing the view's other components
+            if (view.contains(entities[i]))
+            {
+                function(entities[i]);
+            }
+        }
+    });
+}
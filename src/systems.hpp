@@ -1,16 +1,25 @@
 #pragma once
 
+#include <memory>
+
 #include <SDL3/SDL.h>
 
+#include "asset_pack.hpp"
 #include "audio.hpp"
 #include "input.hpp"
+#include "job_system.hpp"
 #include "physics.hpp"
 #include "renderer.hpp"
+#include "thread_pool.hpp"
 
 struct Systems
 {
-    Renderer renderer;
+    AssetPack asset_pack;
+    std::unique_ptr<Renderer> renderer;
     Input input;
-    Physics physics;
-    Audio audio;
+    // declared before everything that runs on it, so that it outlives them
+    JobSystem jobs;
+    Physics physics{&jobs};
+    std::unique_ptr<Audio> audio;
+    ThreadPool thread_pool;
 };
@@ -1,10 +1,12 @@
 #pragma once
 
-#include <string>
+#include <span>
 
 #include <SDL3/SDL_gpu.h>
 #include <spdlog/spdlog.h>
 
+#include "gpu_upload_ring.hpp"
+
 struct GPUTexture
 {
     SDL_GPUDevice *device{nullptr};
@@ -12,8 +14,6 @@ struct GPUTexture
     SDL_GPUSampler *sampler{nullptr};
 
   public:
-    [[nodiscard]] static GPUTexture from_file(SDL_GPUDevice *device, const std::string &path);
-
     [[nodiscard]] static GPUTexture
     depth_target(SDL_GPUDevice *device, uint32_t width, uint32_t height);
 
@@ -37,3 +37,20 @@ struct GPUTexture
         }
     }
 };
+
+struct TextureUpload
+{
+    const uint8_t *src_data;
+    uint32_t src_size;
+    SDL_GPUTexture *dst_texture;
+    uint32_t dst_x;
+    uint32_t dst_y;
+    uint32_t dst_width;
+    uint32_t dst_height;
+};
+
+// Copies every region in `uploads` to its texture through the upload ring with a single copy pass
+// and command buffer.
+[[nodiscard]] bool copy_to_textures(
+    SDL_GPUDevice *device, GPUUploadRing &upload_ring, std::span<const TextureUpload> uploads
+);
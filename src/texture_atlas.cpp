@@ -0,0 +1,191 @@
+#include "texture_atlas.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+bool TextureAtlas::init(SDL_GPUDevice *device, GPUUploadRing *upload_ring)
+{
+    m_device = device;
+    m_upload_ring = upload_ring;
+
+    SDL_GPUSamplerCreateInfo sampler_create_info{
+        .min_filter = SDL_GPU_FILTER_NEAREST,
+        .mag_filter = SDL_GPU_FILTER_NEAREST,
+        .mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST,
+        .address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+        .address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+        .address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+        .mip_lod_bias = 0,
+        .max_anisotropy = 0,
+        .compare_op = SDL_GPU_COMPAREOP_NEVER,
+        .min_lod = 0,
+        .max_lod = 0,
+        .enable_anisotropy = false,
+        .enable_compare = false,
+        .padding1 = 0,
+        .padding2 = 0,
+        .props = 0,
+    };
+    m_sampler = SDL_CreateGPUSampler(m_device, &sampler_create_info);
+    if (!m_sampler)
+    {
+        spdlog::error("TextureAtlas::init: failed to create sampler: {}", SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
+void TextureAtlas::release()
+{
+    for (const auto &page : m_pages)
+    {
+        SDL_ReleaseGPUTexture(m_device, page.texture);
+    }
+    m_pages.clear();
+
+    if (m_sampler != nullptr)
+    {
+        SDL_ReleaseGPUSampler(m_device, m_sampler);
+        m_sampler = nullptr;
+    }
+}
+
+std::vector<AtlasRegion> TextureAtlas::add(std::span<const ImageData> images)
+{
+    m_uploads.clear();
+
+    std::vector<AtlasRegion> regions;
+    regions.reserve(images.size());
+    for (const auto &image : images)
+    {
+        regions.push_back(pack(image));
+    }
+
+    // the staging buffer for images that still need their edges extruded is only sized once
+    // every image has been placed, so pointers into it stay valid until the upload
+    size_t staging_size = 0;
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        if (images[i].padding != PADDING)
+        {
+            staging_size += m_uploads[i].src_size;
+        }
+    }
+    m_padded_pixels.resize(staging_size);
+
+    size_t staging_offset = 0;
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        TextureUpload &upload = m_uploads[i];
+        if (images[i].padding == PADDING)
+        {
+            upload.src_data = images[i].get_pixels();
+        }
+        else
+        {
+            upload.src_data = m_padded_pixels.data() + staging_offset;
+            extrude_image(images[i], PADDING, m_padded_pixels.data() + staging_offset);
+            staging_offset += upload.src_size;
+        }
+    }
+
+    if (!m_uploads.empty() && !copy_to_textures(m_device, *m_upload_ring, m_uploads))
+    {
+        spdlog::error("TextureAtlas::add: failed to copy image data to atlas pages");
+        throw std::runtime_error("failed to copy image data to atlas pages");
+    }
+
+    return regions;
+}
+
+void TextureAtlas::remove(const AtlasRegion &region)
+{
+    Page &page = m_pages[region.page];
+    if (--page.region_count == 0)
+    {
+        page.packer.reset();
+    }
+}
+
+AtlasRegion TextureAtlas::pack(const ImageData &image)
+{
+    uint32_t padded_width = image.width + 2 * PADDING;
+    uint32_t padded_height = image.height + 2 * PADDING;
+
+    std::optional<AtlasRect> rect;
+    uint32_t page_idx = 0;
+    for (; page_idx < m_pages.size(); ++page_idx)
+    {
+        rect = m_pages[page_idx].packer.pack(padded_width, padded_height);
+        if (rect)
+        {
+            break;
+        }
+    }
+
+    if (!rect)
+    {
+        if (!new_page(std::max(PAGE_SIZE, padded_width), std::max(PAGE_SIZE, padded_height)))
+        {
+            throw std::runtime_error("failed to create atlas page");
+        }
+        page_idx = static_cast<uint32_t>(m_pages.size() - 1);
+        rect = m_pages[page_idx].packer.pack(padded_width, padded_height);
+    }
+
+    Page &page = m_pages[page_idx];
+    ++page.region_count;
+    m_uploads.push_back(TextureUpload{
+        .src_data = nullptr,
+        .src_size = padded_width * padded_height * 4,
+        .dst_texture = page.texture,
+        .dst_x = rect->x,
+        .dst_y = rect->y,
+        .dst_width = padded_width,
+        .dst_height = padded_height,
+    });
+
+    float page_width = static_cast<float>(page.packer.get_width());
+    float page_height = static_cast<float>(page.packer.get_height());
+    return AtlasRegion{
+        .page = page_idx,
+        .uv_rect = glm::vec4(
+            static_cast<float>(rect->x + PADDING) / page_width,
+            static_cast<float>(rect->y + PADDING) / page_height,
+            static_cast<float>(image.width) / page_width,
+            static_cast<float>(image.height) / page_height
+        ),
+    };
+}
+
+bool TextureAtlas::new_page(uint32_t width, uint32_t height)
+{
+    SDL_GPUTextureCreateInfo texture_create_info{
+        .type = SDL_GPU_TEXTURETYPE_2D,
+        .format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+        .usage = SDL_GPU_TEXTUREUSAGE_SAMPLER,
+        .width = width,
+        .height = height,
+        .layer_count_or_depth = 1,
+        .num_levels = 1,
+        .sample_count = SDL_GPU_SAMPLECOUNT_1,
+        .props = 0,
+    };
+    SDL_GPUTexture *texture = SDL_CreateGPUTexture(m_device, &texture_create_info);
+    if (!texture)
+    {
+        spdlog::error("TextureAtlas::new_page: failed to create texture: {}", SDL_GetError());
+        return false;
+    }
+
+    m_pages.push_back(Page{
+        .texture = texture,
+        .packer = AtlasPacker(width, height),
+        .region_count = 0,
+    });
+    spdlog::trace("TextureAtlas::new_page: created {}x{} atlas page", width, height);
+
+    return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL_gpu.h>
+#include <glm/glm.hpp>
+
+#include "asset_data.hpp"
+#include "atlas_packer.hpp"
+#include "atlas_region.hpp"
+#include "gpu_upload_ring.hpp"
+#include "texture.hpp"
+
+class TextureAtlas
+{
+  public:
+    static constexpr uint32_t PAGE_SIZE = 2048;
+    // every image is surrounded by a copy of its edge texels so that sampling at the edge of
+    // a region never picks up a neighbouring image
+    static constexpr uint32_t PADDING = 1;
+
+  private:
+
+    struct Page
+    {
+        SDL_GPUTexture *texture;
+        AtlasPacker packer;
+        uint32_t region_count;
+    };
+
+    SDL_GPUDevice *m_device{nullptr};
+    GPUUploadRing *m_upload_ring{nullptr};
+    SDL_GPUSampler *m_sampler{nullptr};
+    std::vector<Page> m_pages;
+
+    std::vector<uint8_t> m_padded_pixels;
+    std::vector<TextureUpload> m_uploads;
+
+  public:
+    [[nodiscard]] bool init(SDL_GPUDevice *device, GPUUploadRing *upload_ring);
+
+    void release();
+
+    // Packs all images and uploads them with a single command buffer, throws if a page could not
+    // be created or the upload failed. Images that already carry `PADDING` texels of extruded
+    // edge, such as those from an asset pack, are copied to the GPU straight from their pixels.
+    [[nodiscard]] std::vector<AtlasRegion> add(std::span<const ImageData> images);
+
+    // The skyline packer cannot free single rectangles, so a page's space is only reused once
+    // every region on it has been removed.
+    void remove(const AtlasRegion &region);
+
+    [[nodiscard]] SDL_GPUTextureSamplerBinding get_binding(uint32_t page) const noexcept
+    {
+        return SDL_GPUTextureSamplerBinding{
+            .texture = m_pages[page].texture,
+            .sampler = m_sampler,
+        };
+    }
+
+    [[nodiscard]] size_t get_page_count() const
+    {
+        return m_pages.size();
+    }
+
+  private:
+    [[nodiscard]] bool new_page(uint32_t width, uint32_t height);
+
+    [[nodiscard]] AtlasRegion pack(const ImageData &image);
+};
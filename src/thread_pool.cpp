@@ -0,0 +1,50 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t thread_count)
+{
+    if (thread_count == 0)
+    {
+        thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    m_threads.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        m_threads.emplace_back([this] { run_worker(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_task_available.notify_all();
+
+    for (auto &thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::run_worker()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(m_mutex);
+            m_task_available.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty())
+            {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads running submitted tasks in FIFO order.
+class ThreadPool
+{
+    std::vector<std::thread> m_threads;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_task_available;
+    bool m_stopping{false};
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+  public:
+    // 0 uses one thread per hardware thread, minus the main thread
+    explicit ThreadPool(size_t thread_count = 0);
+
+    // finishes all queued tasks before joining the workers
+    ~ThreadPool();
+
+    template<typename F>
+    [[nodiscard]] std::future<std::invoke_result_t<F>> submit(F &&task)
+    {
+        // std::function needs a copyable callable, so the packaged task is shared
+        auto packaged =
+            std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(task));
+        std::future<std::invoke_result_t<F>> future = packaged->get_future();
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.emplace([packaged] { (*packaged)(); });
+        }
+        m_task_available.notify_one();
+        return future;
+    }
+
+    [[nodiscard]] size_t get_thread_count() const
+    {
+        return m_threads.size();
+    }
+
+  private:
+    void run_worker();
+};
@@ -0,0 +1,105 @@
+#include "tilemap.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Tilemap::Tilemap(uint32_t width, uint32_t height, float tile_size, const glm::vec2 &origin)
+    : m_width(width), m_height(height), m_tile_size(tile_size), m_origin(origin),
+      m_chunks(static_cast<size_t>(get_chunk_columns()) * get_chunk_rows()),
+      m_chunk_revisions(static_cast<size_t>(get_chunk_columns()) * get_chunk_rows(), 0),
+      m_chunk_is_dirty(static_cast<size_t>(get_chunk_columns()) * get_chunk_rows(), 0)
+{
+}
+
+Aabb Tilemap::get_chunk_bounds(uint32_t chunk_x, uint32_t chunk_y) const
+{
+    uint32_t first_x = chunk_x * CHUNK_SIZE;
+    uint32_t first_y = chunk_y * CHUNK_SIZE;
+    uint32_t last_x = std::min(first_x + CHUNK_SIZE, m_width);
+    uint32_t last_y = std::min(first_y + CHUNK_SIZE, m_height);
+    return Aabb{
+        .min = m_origin + glm::vec2(
+                              static_cast<float>(first_x) * m_tile_size,
+                              static_cast<float>(m_height - last_y) * m_tile_size
+                          ),
+        .max = m_origin + glm::vec2(
+                              static_cast<float>(last_x) * m_tile_size,
+                              static_cast<float>(m_height - first_y) * m_tile_size
+                          ),
+    };
+}
+
+Tilemap::ChunkRange Tilemap::get_chunk_range(const Aabb &bounds) const
+{
+    float map_top = m_origin.y + static_cast<float>(m_height) * m_tile_size;
+    auto clamp_tile = [&](float offset, uint32_t tile_count) {
+        float tile = std::floor(offset / m_tile_size);
+        return static_cast<uint32_t>(std::clamp(tile, 0.0f, static_cast<float>(tile_count)));
+    };
+
+    // tile rows are counted from the top
+    uint32_t first_x = clamp_tile(bounds.min.x - m_origin.x, m_width);
+    uint32_t first_y = clamp_tile(map_top - bounds.max.y, m_height);
+    uint32_t end_x = clamp_tile(bounds.max.x - m_origin.x + m_tile_size, m_width);
+    uint32_t end_y = clamp_tile(map_top - bounds.min.y + m_tile_size, m_height);
+    if (first_x >= end_x || first_y >= end_y)
+    {
+        return ChunkRange{.first_x = 0, .first_y = 0, .end_x = 0, .end_y = 0};
+    }
+
+    return ChunkRange{
+        .first_x = first_x / CHUNK_SIZE,
+        .first_y = first_y / CHUNK_SIZE,
+        .end_x = (end_x + CHUNK_SIZE - 1) / CHUNK_SIZE,
+        .end_y = (end_y + CHUNK_SIZE - 1) / CHUNK_SIZE,
+    };
+}
+
+void Tilemap::clear_dirty_chunks()
+{
+    for (size_t chunk_idx : m_dirty_chunks)
+    {
+        m_chunk_is_dirty[chunk_idx] = 0;
+    }
+    m_dirty_chunks.clear();
+}
+
+void Tilemap::set(uint32_t x, uint32_t y, std::optional<TextureId> tile)
+{
+    size_t chunk_idx = get_chunk_index(x / CHUNK_SIZE, y / CHUNK_SIZE);
+    auto &chunk = m_chunks[chunk_idx];
+    if (chunk == nullptr)
+    {
+        if (!tile)
+        {
+            return;
+        }
+        chunk = std::make_unique<Chunk>();
+    }
+
+    auto &current = chunk->tiles[(y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE];
+    if (current == tile)
+    {
+        return;
+    }
+
+    if (!current)
+    {
+        ++chunk->tile_count;
+    }
+    else if (!tile)
+    {
+        --chunk->tile_count;
+    }
+    current = tile;
+    if (chunk->tile_count == 0)
+    {
+        chunk.reset();
+    }
+    ++m_chunk_revisions[chunk_idx];
+    if (m_chunk_is_dirty[chunk_idx] == 0)
+    {
+        m_chunk_is_dirty[chunk_idx] = 1;
+        m_dirty_chunks.push_back(chunk_idx);
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "aabb.hpp"
+#include "renderer.hpp"
+
+// A grid of static tiles that is rendered in fixed-size chunks instead of as individual
+// entities. Every chunk carries a revision number that is bumped whenever one of its tiles
+// changes, so renderers can tell which of their cached chunks are out of date. Changed chunks
+// are also listed until the list is cleared, so the renderer only looks at those instead of
+// every chunk of the map. Tiles are only stored for chunks that have at least one tile, so a
+// large map that is streamed in and out only holds memory for the chunks that are loaded.
+class Tilemap
+{
+  public:
+    static constexpr uint32_t CHUNK_SIZE = 16;
+
+    // chunks `first_x` to `end_x` - 1 of rows `first_y` to `end_y` - 1
+    struct ChunkRange
+    {
+        uint32_t first_x;
+        uint32_t first_y;
+        uint32_t end_x;
+        uint32_t end_y;
+    };
+
+  private:
+    uint32_t m_width;
+    uint32_t m_height;
+    float m_tile_size;
+    glm::vec2 m_origin;
+
+    struct Chunk
+    {
+        std::array<std::optional<TextureId>, CHUNK_SIZE * CHUNK_SIZE> tiles;
+        uint32_t tile_count{0};
+    };
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    std::vector<uint64_t> m_chunk_revisions;
+    std::vector<size_t> m_dirty_chunks;
+    std::vector<uint8_t> m_chunk_is_dirty;
+
+  public:
+    // `origin` is the world position of the bottom-left corner of the map, tile rows are
+    // counted from the top
+    Tilemap(uint32_t width, uint32_t height, float tile_size, const glm::vec2 &origin);
+
+    void set(uint32_t x, uint32_t y, std::optional<TextureId> tile);
+
+    [[nodiscard]] std::optional<TextureId> get(uint32_t x, uint32_t y) const
+    {
+        const auto &chunk = m_chunks[get_chunk_index(x / CHUNK_SIZE, y / CHUNK_SIZE)];
+        if (chunk == nullptr)
+        {
+            return {};
+        }
+        return chunk->tiles[(y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE];
+    }
+
+    [[nodiscard]] uint32_t get_width() const
+    {
+        return m_width;
+    }
+
+    [[nodiscard]] uint32_t get_height() const
+    {
+        return m_height;
+    }
+
+    [[nodiscard]] float get_tile_size() const
+    {
+        return m_tile_size;
+    }
+
+    [[nodiscard]] const glm::vec2 &get_origin() const
+    {
+        return m_origin;
+    }
+
+    // world position of the bottom-left corner of a tile
+    [[nodiscard]] glm::vec2 get_tile_position(uint32_t x, uint32_t y) const
+    {
+        return m_origin + glm::vec2(
+                              static_cast<float>(x) * m_tile_size,
+                              static_cast<float>(m_height - 1 - y) * m_tile_size
+                          );
+    }
+
+    [[nodiscard]] uint32_t get_chunk_columns() const
+    {
+        return (m_width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    }
+
+    [[nodiscard]] uint32_t get_chunk_rows() const
+    {
+        return (m_height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    }
+
+    [[nodiscard]] Aabb get_chunk_bounds(uint32_t chunk_x, uint32_t chunk_y) const;
+
+    // the chunks overlapping `bounds`, empty if it lies outside the map
+    [[nodiscard]] ChunkRange get_chunk_range(const Aabb &bounds) const;
+
+    [[nodiscard]] uint64_t get_chunk_revision(uint32_t chunk_x, uint32_t chunk_y) const
+    {
+        return m_chunk_revisions[get_chunk_index(chunk_x, chunk_y)];
+    }
+
+    [[nodiscard]] bool is_chunk_empty(uint32_t chunk_x, uint32_t chunk_y) const
+    {
+        return m_chunks[get_chunk_index(chunk_x, chunk_y)] == nullptr;
+    }
+
+    // Indices, `chunk_y * get_chunk_columns() + chunk_x`, of the chunks whose revision changed
+    // since the last `clear_dirty_chunks`, each listed once.
+    [[nodiscard]] const std::vector<size_t> &get_dirty_chunks() const
+    {
+        return m_dirty_chunks;
+    }
+
+    void clear_dirty_chunks();
+
+  private:
+    [[nodiscard]] size_t get_chunk_index(uint32_t chunk_x, uint32_t chunk_y) const
+    {
+        return static_cast<size_t>(chunk_y) * get_chunk_columns() + chunk_x;
+    }
+};
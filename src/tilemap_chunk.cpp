@@ -0,0 +1,40 @@
+#include "tilemap_chunk.hpp"
+
+#include <algorithm>
+
+void build_tilemap_chunk(
+    const Tilemap &tilemap, uint32_t chunk_x, uint32_t chunk_y,
+    const std::function<const AtlasRegion &(TextureId)> &resolve_texture, SpriteBatch &batch
+)
+{
+    batch.clear();
+
+    uint32_t first_x = chunk_x * Tilemap::CHUNK_SIZE;
+    uint32_t first_y = chunk_y * Tilemap::CHUNK_SIZE;
+    uint32_t last_x = std::min(first_x + Tilemap::CHUNK_SIZE, tilemap.get_width());
+    uint32_t last_y = std::min(first_y + Tilemap::CHUNK_SIZE, tilemap.get_height());
+
+    for (uint32_t y = first_y; y < last_y; ++y)
+    {
+        for (uint32_t x = first_x; x < last_x; ++x)
+        {
+            std::optional<TextureId> tile = tilemap.get(x, y);
+            if (!tile)
+            {
+                continue;
+            }
+
+            const AtlasRegion &region = resolve_texture(*tile);
+            batch.add(SpriteInstance{
+                .uv_rect = region.uv_rect,
+                .position = tilemap.get_tile_position(x, y),
+                .size = glm::vec2(tilemap.get_tile_size()),
+                .flipped = glm::vec2(1.0f),
+                .z = 0.0f,
+                .page = region.page,
+            });
+        }
+    }
+
+    batch.build();
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <functional>
+
+#include "atlas_region.hpp"
+#include "sprite_batch.hpp"
+#include "tilemap.hpp"
+
+// Fills `batch` with one sprite instance for every tile of the given chunk, grouped by atlas
+// page. Does not touch the GPU, the result is uploaded once and redrawn until the chunk's
+// revision changes.
+void build_tilemap_chunk(
+    const Tilemap &tilemap, uint32_t chunk_x, uint32_t chunk_y,
+    const std::function<const AtlasRegion &(TextureId)> &resolve_texture, SpriteBatch &batch
+);
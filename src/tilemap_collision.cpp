@@ -0,0 +1,57 @@
+#include "tilemap_collision.hpp"
+
+std::vector<TileRect>
+merge_solid_tiles(uint32_t width, uint32_t height, std::span<const uint8_t> solid)
+{
+    std::vector<TileRect> rects;
+    std::vector<uint8_t> claimed(solid.size(), 0);
+
+    auto is_free = [&](uint32_t x, uint32_t y) {
+        size_t idx = static_cast<size_t>(y) * width + x;
+        return solid[idx] != 0 && claimed[idx] == 0;
+    };
+
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            if (!is_free(x, y))
+            {
+                continue;
+            }
+
+            uint32_t run_width = 1;
+            while (x + run_width < width && is_free(x + run_width, y))
+            {
+                ++run_width;
+            }
+
+            uint32_t run_height = 1;
+            while (y + run_height < height)
+            {
+                bool row_free = true;
+                for (uint32_t dx = 0; dx < run_width && row_free; ++dx)
+                {
+                    row_free = is_free(x + dx, y + run_height);
+                }
+                if (!row_free)
+                {
+                    break;
+                }
+                ++run_height;
+            }
+
+            for (uint32_t dy = 0; dy < run_height; ++dy)
+            {
+                for (uint32_t dx = 0; dx < run_width; ++dx)
+                {
+                    claimed[static_cast<size_t>(y + dy) * width + x + dx] = 1;
+                }
+            }
+
+            rects.push_back(TileRect{.x = x, .y = y, .width = run_width, .height = run_height});
+        }
+    }
+
+    return rects;
+}
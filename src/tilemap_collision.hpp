@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// A rectangle of cells, `y` counts rows from the top of the map.
+struct TileRect
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+// Greedily merges the solid cells of a `width` x `height` grid (row-major, non-zero means
+// solid) into non-overlapping rectangles covering exactly the solid cells. Runs are first
+// grown along a row and then downwards for as long as every cell below the run is solid and
+// unclaimed, so the result only depends on the grid contents.
+[[nodiscard]] std::vector<TileRect>
+merge_solid_tiles(uint32_t width, uint32_t height, std::span<const uint8_t> solid);
@@ -0,0 +1,52 @@
+#include "upload_ring.hpp"
+
+#include <cassert>
+
+static uint64_t align_up(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+UploadRing::UploadRing(uint64_t capacity) : m_capacity(capacity)
+{
+}
+
+std::optional<uint64_t> UploadRing::allocate(uint64_t size, uint64_t alignment)
+{
+    assert((alignment & (alignment - 1)) == 0 && m_capacity % alignment == 0);
+    if (size > m_capacity)
+    {
+        return {};
+    }
+
+    uint64_t start = align_up(m_head, alignment);
+    // allocations never wrap around the end of the buffer, the rest of the lap is skipped instead
+    if (start % m_capacity + size > m_capacity)
+    {
+        start = (start / m_capacity + 1) * m_capacity;
+    }
+
+    if (start + size - m_tail > m_capacity)
+    {
+        return {};
+    }
+
+    m_head = start + size;
+    return start % m_capacity;
+}
+
+uint64_t UploadRing::submit()
+{
+    uint64_t id = m_next_submission_id++;
+    m_submissions.push_back(Submission{.id = id, .end = m_head});
+    return id;
+}
+
+void UploadRing::release(uint64_t submission_id)
+{
+    while (!m_submissions.empty() && m_submissions.front().id <= submission_id)
+    {
+        m_tail = m_submissions.front().end;
+        m_submissions.pop_front();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+// Sub-allocates a fixed-size buffer as a ring. Allocations are grouped into submissions, and the
+// space of a submission is only reused once `release` is called for it, which for GPU uploads
+// happens when the fence of the command buffer that read the data has signaled. Holds no memory
+// itself, it only hands out offsets.
+class UploadRing
+{
+    struct Submission
+    {
+        uint64_t id;
+        uint64_t end;
+    };
+
+    uint64_t m_capacity;
+    // positions are counted in bytes since creation and only wrap modulo `m_capacity` when
+    // turned into offsets, so `m_head - m_tail` is always the space in use
+    uint64_t m_head{0};
+    uint64_t m_tail{0};
+    uint64_t m_next_submission_id{0};
+    std::deque<Submission> m_submissions;
+
+  public:
+    explicit UploadRing(uint64_t capacity);
+
+    // Offset of `size` contiguous bytes, or nothing if the ring does not have that much free space
+    // in one piece. `alignment` must be a power of two that divides the capacity, the capacity
+    // itself may have any size.
+    [[nodiscard]] std::optional<uint64_t> allocate(uint64_t size, uint64_t alignment = 16);
+
+    // Closes the current submission, every allocation since the previous call belongs to it.
+    [[nodiscard]] uint64_t submit();
+
+    // Frees the space of all submissions up to and including `submission_id`.
+    void release(uint64_t submission_id);
+
+    [[nodiscard]] uint64_t get_capacity() const
+    {
+        return m_capacity;
+    }
+
+    [[nodiscard]] uint64_t get_used() const
+    {
+        return m_head - m_tail;
+    }
+
+    [[nodiscard]] size_t get_pending_submission_count() const
+    {
+        return m_submissions.size();
+    }
+};
@@ -0,0 +1,155 @@
+#include "wav_reader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+#include <spdlog/spdlog.h>
+
+namespace
+{
+
+constexpr uint16_t WAVE_FORMAT_PCM = 1;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint16_t read_u16(const uint8_t *data)
+{
+    return static_cast<uint16_t>(data[0] | data[1] << 8);
+}
+
+uint32_t read_u32(const uint8_t *data)
+{
+    return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+           static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+}
+
+SDL_AudioFormat get_sample_format(uint16_t format_tag, uint16_t bits_per_sample)
+{
+    if (format_tag == WAVE_FORMAT_PCM)
+    {
+        switch (bits_per_sample)
+        {
+        case 8:
+            return SDL_AUDIO_U8;
+        case 16:
+            return SDL_AUDIO_S16LE;
+        case 32:
+            return SDL_AUDIO_S32LE;
+        default:
+            break;
+        }
+    }
+    else if (format_tag == WAVE_FORMAT_IEEE_FLOAT && bits_per_sample == 32)
+    {
+        return SDL_AUDIO_F32LE;
+    }
+    return SDL_AUDIO_UNKNOWN;
+}
+
+} // namespace
+
+bool WavReader::open(const std::string &path)
+{
+    m_file = std::ifstream(path, std::ios::binary);
+    if (!m_file.is_open())
+    {
+        spdlog::error("WavReader::open: failed to open file {}", path);
+        return false;
+    }
+
+    std::array<uint8_t, 12> riff{};
+    if (!m_file.read(reinterpret_cast<char *>(riff.data()), riff.size()) ||
+        std::string_view(reinterpret_cast<const char *>(riff.data()), 4) != "RIFF" ||
+        std::string_view(reinterpret_cast<const char *>(riff.data() + 8), 4) != "WAVE")
+    {
+        spdlog::error("WavReader::open: {} is not a wav file", path);
+        return false;
+    }
+
+    bool found_format = false;
+    std::array<uint8_t, 40> format{};
+    std::array<uint8_t, 8> chunk{};
+    while (m_file.read(reinterpret_cast<char *>(chunk.data()), chunk.size()))
+    {
+        std::string_view id(reinterpret_cast<const char *>(chunk.data()), 4);
+        uint32_t size = read_u32(chunk.data() + 4);
+        std::streamoff start = m_file.tellg();
+
+        if (id == "fmt " && size >= 16)
+        {
+            m_file.read(reinterpret_cast<char *>(format.data()), std::min<size_t>(size, 40));
+            uint16_t format_tag = read_u16(format.data());
+            if (format_tag == WAVE_FORMAT_EXTENSIBLE && size >= 26)
+            {
+                // the real format tag is the start of the sub format guid
+                format_tag = read_u16(format.data() + 24);
+            }
+            uint16_t bits_per_sample = read_u16(format.data() + 14);
+
+            m_spec = SDL_AudioSpec{
+                .format = get_sample_format(format_tag, bits_per_sample),
+                .channels = read_u16(format.data() + 2),
+                .freq = static_cast<int>(read_u32(format.data() + 4)),
+            };
+            m_frame_size = read_u16(format.data() + 12);
+            if (m_spec.format == SDL_AUDIO_UNKNOWN || m_spec.channels == 0 || m_frame_size == 0)
+            {
+                spdlog::error(
+                    "WavReader::open: {} has unsupported format {} with {} bits per sample",
+                    path,
+                    format_tag,
+                    bits_per_sample
+                );
+                return false;
+            }
+            found_format = true;
+        }
+        else if (id == "data" && found_format)
+        {
+            m_data_offset = static_cast<uint64_t>(start);
+            m_file.seekg(0, std::ios::end);
+            uint64_t file_size = static_cast<uint64_t>(m_file.tellg());
+            // streamed writers often leave the size of the last chunk unset
+            m_data_size = std::min<uint64_t>(size, file_size - m_data_offset);
+            m_data_size -= m_data_size % m_frame_size;
+            rewind();
+            return true;
+        }
+
+        // chunks are padded to an even size
+        m_file.seekg(start + static_cast<std::streamoff>(size + (size & 1)));
+    }
+
+    spdlog::error("WavReader::open: {} has no {} chunk", path, found_format ? "data" : "fmt");
+    return false;
+}
+
+size_t WavReader::read(std::span<uint8_t> dst)
+{
+    uint64_t count = std::min<uint64_t>(dst.size(), m_data_size - m_position);
+    count -= count % m_frame_size;
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    m_file.read(reinterpret_cast<char *>(dst.data()), static_cast<std::streamsize>(count));
+    size_t read = static_cast<size_t>(m_file.gcount());
+    if (read != count)
+    {
+        spdlog::error("WavReader::read: file ended {} bytes early", m_data_size - m_position);
+        m_position = m_data_size;
+        return read - read % m_frame_size;
+    }
+
+    m_position += read;
+    return read;
+}
+
+void WavReader::rewind()
+{
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(m_data_offset));
+    m_position = 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+
+#include <SDL3/SDL_audio.h>
+
+// Reads the PCM samples of a WAV file incrementally, for sounds too long to keep in memory.
+// Supports 8, 16 and 32 bit integer and 32 bit float samples.
+class WavReader
+{
+    std::ifstream m_file;
+    SDL_AudioSpec m_spec{};
+    uint32_t m_frame_size{0};
+    uint64_t m_data_offset{0};
+    uint64_t m_data_size{0};
+    uint64_t m_position{0};
+
+  public:
+    [[nodiscard]] bool open(const std::string &path);
+
+    // Reads up to `dst.size()` bytes of whole frames, returns 0 at the end of the samples.
+    [[nodiscard]] size_t read(std::span<uint8_t> dst);
+
+    void rewind();
+
+    [[nodiscard]] const SDL_AudioSpec &get_spec() const
+    {
+        return m_spec;
+    }
+
+    [[nodiscard]] uint64_t get_data_size() const
+    {
+        return m_data_size;
+    }
+};